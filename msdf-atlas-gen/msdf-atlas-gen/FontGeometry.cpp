@@ -23,9 +23,9 @@ const GlyphGeometry * FontGeometry::GlyphRange::end() const {
     return glyphs->data()+rangeEnd;
 }
 
-FontGeometry::FontGeometry() : geometryScale(1), metrics(), preferredIdentifierType(GlyphIdentifierType::UNICODE_CODEPOINT), glyphs(&ownGlyphs), rangeStart(glyphs->size()), rangeEnd(glyphs->size()) { }
+FontGeometry::FontGeometry() : geometryScale(1), metrics(), preferredIdentifierType(GlyphIdentifierType::UNICODE_CODEPOINT), glyphs(&ownGlyphs), edgeArena(nullptr), shapeCache(nullptr), fontHash(0), rangeStart(glyphs->size()), rangeEnd(glyphs->size()) { }
 
-FontGeometry::FontGeometry(std::vector<GlyphGeometry> *glyphStorage) : geometryScale(1), metrics(), preferredIdentifierType(GlyphIdentifierType::UNICODE_CODEPOINT), glyphs(glyphStorage), rangeStart(glyphs->size()), rangeEnd(glyphs->size()) { }
+FontGeometry::FontGeometry(std::vector<GlyphGeometry> *glyphStorage, msdfgen::EdgeArena *edgeArena) : geometryScale(1), metrics(), preferredIdentifierType(GlyphIdentifierType::UNICODE_CODEPOINT), glyphs(glyphStorage), edgeArena(edgeArena), shapeCache(nullptr), fontHash(0), rangeStart(glyphs->size()), rangeEnd(glyphs->size()) { }
 
 int FontGeometry::loadGlyphset(msdfgen::FontHandle *font, double fontScale, const Charset &glyphset, bool preprocessGeometry, bool enableKerning) {
     if (!(glyphs->size() == rangeEnd && loadMetrics(font, fontScale)))
@@ -34,7 +34,7 @@ int FontGeometry::loadGlyphset(msdfgen::FontHandle *font, double fontScale, cons
     int loaded = 0;
     for (unicode_t index : glyphset) {
         GlyphGeometry glyph;
-        if (glyph.load(font, geometryScale, msdfgen::GlyphIndex(index), preprocessGeometry)) {
+        if (glyph.load(font, geometryScale, msdfgen::GlyphIndex(index), preprocessGeometry, edgeArena, shapeCache, fontHash)) {
             addGlyph((GlyphGeometry &&) glyph);
             ++loaded;
         }
@@ -52,7 +52,7 @@ int FontGeometry::loadCharset(msdfgen::FontHandle *font, double fontScale, const
     int loaded = 0;
     for (unicode_t cp : charset) {
         GlyphGeometry glyph;
-        if (glyph.load(font, geometryScale, cp, preprocessGeometry)) {
+        if (glyph.load(font, geometryScale, cp, preprocessGeometry, edgeArena, shapeCache, fontHash)) {
             addGlyph((GlyphGeometry &&) glyph);
             ++loaded;
         }
@@ -120,6 +120,11 @@ void FontGeometry::setName(const char *name) {
         this->name.clear();
 }
 
+void FontGeometry::setShapeCache(ShapeCache *shapeCache, unsigned long long fontHash) {
+    this->shapeCache = shapeCache;
+    this->fontHash = fontHash;
+}
+
 double FontGeometry::getGeometryScale() const {
     return geometryScale;
 }
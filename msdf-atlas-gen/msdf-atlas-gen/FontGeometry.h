@@ -33,7 +33,8 @@ public:
     };
 
     FontGeometry();
-    explicit FontGeometry(std::vector<GlyphGeometry> *glyphStorage);
+    /// If edgeArena is not null, the edges of loaded glyphs are allocated from it, so it must outlive the glyphs in glyphStorage
+    explicit FontGeometry(std::vector<GlyphGeometry> *glyphStorage, msdfgen::EdgeArena *edgeArena = nullptr);
 
     /// Loads all glyphs in a glyphset (Charset elements are glyph indices), returns the number of successfully loaded glyphs
     int loadGlyphset(msdfgen::FontHandle *font, double fontScale, const Charset &glyphset, bool preprocessGeometry = true, bool enableKerning = true);
@@ -49,6 +50,8 @@ public:
     int loadKerning(msdfgen::FontHandle *font);
     /// Sets a name to be associated with the font
     void setName(const char *name);
+    /// Sets a cache of preprocessed glyph shapes, in which the font is identified by fontHash (see ShapeCache::hashFontFile), to be used when loading glyphs
+    void setShapeCache(ShapeCache *shapeCache, unsigned long long fontHash);
 
     /// Returns the geometry scale to be used when loading glyphs
     double getGeometryScale() const;
@@ -74,6 +77,9 @@ private:
     msdfgen::FontMetrics metrics;
     GlyphIdentifierType preferredIdentifierType;
     std::vector<GlyphGeometry> *glyphs;
+    msdfgen::EdgeArena *edgeArena;
+    ShapeCache *shapeCache;
+    unsigned long long fontHash;
     size_t rangeStart, rangeEnd;
     std::map<int, size_t> glyphsByIndex;
     std::map<unicode_t, size_t> glyphsByCodepoint;
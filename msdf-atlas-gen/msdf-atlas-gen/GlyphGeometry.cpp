@@ -8,22 +8,23 @@ namespace msdf_atlas {
 
 GlyphGeometry::GlyphGeometry() : index(), codepoint(), geometryScale(), bounds(), advance(), box() { }
 
-bool GlyphGeometry::load(msdfgen::FontHandle *font, double geometryScale, msdfgen::GlyphIndex index, bool preprocessGeometry) {
-    if (font && msdfgen::loadGlyph(shape, font, index, &advance) && shape.validate()) {
-        this->index = index.getIndex();
-        this->geometryScale = geometryScale;
-        codepoint = 0;
-        advance *= geometryScale;
+bool GlyphGeometry::load(msdfgen::FontHandle *font, double geometryScale, msdfgen::GlyphIndex index, bool preprocessGeometry, msdfgen::EdgeArena *edgeArena, ShapeCache *shapeCache, unsigned long long fontHash) {
+    #ifdef MSDFGEN_USE_SKIA
+        bool resolveGeometry = preprocessGeometry;
+    #else
+        bool resolveGeometry = false;
+    #endif
+    double glyphAdvance = 0;
+    if (shapeCache && shapeCache->get(shape, glyphAdvance, fontHash, index.getIndex(), resolveGeometry, edgeArena))
+        bounds = shape.getBounds();
+    else if (font && msdfgen::loadGlyph(shape, font, index, &glyphAdvance, edgeArena) && shape.validate()) {
         #ifdef MSDFGEN_USE_SKIA
-            if (preprocessGeometry)
+            if (resolveGeometry)
                 msdfgen::resolveShapeGeometry(shape);
         #endif
         shape.normalize();
         bounds = shape.getBounds();
-        #ifdef MSDFGEN_USE_SKIA
-            if (!preprocessGeometry)
-        #endif
-        {
+        if (!resolveGeometry) {
             // Determine if shape is winded incorrectly and reverse it in that case
             msdfgen::Point2 outerPoint(bounds.l-(bounds.r-bounds.l)-1, bounds.b-(bounds.t-bounds.b)-1);
             if (msdfgen::SimpleTrueShapeDistanceFinder::oneShotDistance(shape, outerPoint) > 0) {
@@ -31,15 +32,21 @@ bool GlyphGeometry::load(msdfgen::FontHandle *font, double geometryScale, msdfge
                     contour.reverse();
             }
         }
-        return true;
-    }
-    return false;
+        if (shapeCache)
+            shapeCache->set(fontHash, index.getIndex(), resolveGeometry, shape, glyphAdvance);
+    } else
+        return false;
+    this->index = index.getIndex();
+    this->geometryScale = geometryScale;
+    codepoint = 0;
+    advance = glyphAdvance*geometryScale;
+    return true;
 }
 
-bool GlyphGeometry::load(msdfgen::FontHandle *font, double geometryScale, unicode_t codepoint, bool preprocessGeometry) {
+bool GlyphGeometry::load(msdfgen::FontHandle *font, double geometryScale, unicode_t codepoint, bool preprocessGeometry, msdfgen::EdgeArena *edgeArena, ShapeCache *shapeCache, unsigned long long fontHash) {
     msdfgen::GlyphIndex index;
     if (msdfgen::getGlyphIndex(index, font, codepoint)) {
-        if (load(font, geometryScale, index, preprocessGeometry)) {
+        if (load(font, geometryScale, index, preprocessGeometry, edgeArena, shapeCache, fontHash)) {
             this->codepoint = codepoint;
             return true;
         }
@@ -74,6 +81,11 @@ void GlyphGeometry::wrapBox(double scale, double range, double miterLimit) {
     }
 }
 
+void GlyphGeometry::convertCubicsToQuadratics(double tolerance) {
+    if (box.scale > 0)
+        shape.convertCubicsToQuadratics(tolerance/box.scale);
+}
+
 void GlyphGeometry::placeBox(int x, int y) {
     box.rect.x = x, box.rect.y = y;
 }
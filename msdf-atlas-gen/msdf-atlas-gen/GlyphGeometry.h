@@ -6,6 +6,7 @@
 #include "types.h"
 #include "Rectangle.h"
 #include "GlyphBox.h"
+#include "ShapeCache.h"
 
 namespace msdf_atlas {
 
@@ -14,13 +15,16 @@ class GlyphGeometry {
 
 public:
     GlyphGeometry();
-    /// Loads glyph geometry from font
-    bool load(msdfgen::FontHandle *font, double geometryScale, msdfgen::GlyphIndex index, bool preprocessGeometry = true);
-    bool load(msdfgen::FontHandle *font, double geometryScale, unicode_t codepoint, bool preprocessGeometry = true);
+    /// Loads glyph geometry from font, allocating its edges from edgeArena if not null.
+    /// If shapeCache is not null, the preprocessed shape is taken from it if present under fontHash, or added to it otherwise
+    bool load(msdfgen::FontHandle *font, double geometryScale, msdfgen::GlyphIndex index, bool preprocessGeometry = true, msdfgen::EdgeArena *edgeArena = nullptr, ShapeCache *shapeCache = nullptr, unsigned long long fontHash = 0);
+    bool load(msdfgen::FontHandle *font, double geometryScale, unicode_t codepoint, bool preprocessGeometry = true, msdfgen::EdgeArena *edgeArena = nullptr, ShapeCache *shapeCache = nullptr, unsigned long long fontHash = 0);
     /// Applies edge coloring to glyph shape
     void edgeColoring(void (*fn)(msdfgen::Shape &, double, unsigned long long), double angleThreshold, unsigned long long seed);
     /// Computes the dimensions of the glyph's box as well as the transformation for the generator function
     void wrapBox(double scale, double range, double miterLimit);
+    /// Converts the cubic curves of the glyph shape to quadratic curves within tolerance in pixels of the glyph's box, keeping edge colors. Must be called after wrapBox
+    void convertCubicsToQuadratics(double tolerance);
     /// Sets the glyph's box's position in the atlas
     void placeBox(int x, int y);
     /// Sets the glyph's box's rectangle in the atlas
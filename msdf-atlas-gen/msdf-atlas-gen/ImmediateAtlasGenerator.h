@@ -27,6 +27,9 @@ public:
     void setAttributes(const GeneratorAttributes &attributes);
     /// Sets the number of threads to be run by generate
     void setThreadCount(int threadCount);
+    /// Makes the generated atlas independent of the number of threads and the CPU's instruction set.
+    /// Glyphs whose boxes share border pixels are put into the atlas in order, which requires a buffer for all glyphs at once, and SIMD is disabled
+    void setDeterministic(bool deterministic);
     /// Allows access to the underlying AtlasStorage
     const AtlasStorage & atlasStorage() const;
     /// Returns the layout of the contained glyphs as a list of GlyphBoxes
@@ -36,9 +39,10 @@ private:
     AtlasStorage storage;
     std::vector<GlyphBox> layout;
     std::vector<T> glyphBuffer;
-    std::vector<byte> errorCorrectionBuffer;
+    std::vector<msdfgen::GeneratorContext> threadContexts;
     GeneratorAttributes attributes;
     int threadCount;
+    bool deterministic;
 
 };
 
@@ -6,41 +6,68 @@
 namespace msdf_atlas {
 
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
-ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::ImmediateAtlasGenerator() : threadCount(1) { }
+ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::ImmediateAtlasGenerator() : threadCount(1), deterministic(false) { }
 
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
-ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::ImmediateAtlasGenerator(int width, int height) : storage(width, height), threadCount(1) { }
+ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::ImmediateAtlasGenerator(int width, int height) : storage(width, height), threadCount(1), deterministic(false) { }
 
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
 void ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::generate(const GlyphGeometry *glyphs, int count) {
     int maxBoxArea = 0;
+    std::vector<int> glyphOffsets;
+    if (deterministic)
+        glyphOffsets.resize(count+1);
     for (int i = 0; i < count; ++i) {
         GlyphBox box = glyphs[i];
         maxBoxArea = std::max(maxBoxArea, box.rect.w*box.rect.h);
+        if (deterministic)
+            glyphOffsets[i+1] = glyphOffsets[i]+N*box.rect.w*box.rect.h;
         layout.push_back((GlyphBox &&) box);
     }
+    // In deterministic mode, each glyph has its own part of the buffer until all of them are put into storage in order,
+    // otherwise each thread reuses one part and puts its glyph into storage as soon as it is generated
     int threadBufferSize = N*maxBoxArea;
-    if (threadCount*threadBufferSize > (int) glyphBuffer.size())
-        glyphBuffer.resize(threadCount*threadBufferSize);
-    if (threadCount*maxBoxArea > (int) errorCorrectionBuffer.size())
-        errorCorrectionBuffer.resize(threadCount*maxBoxArea);
+    int bufferSize = deterministic ? glyphOffsets[count] : threadCount*threadBufferSize;
+    if (bufferSize > (int) glyphBuffer.size())
+        glyphBuffer.resize(bufferSize);
+    if (threadCount > (int) threadContexts.size())
+        threadContexts.resize(threadCount);
     std::vector<GeneratorAttributes> threadAttributes(threadCount);
     for (int i = 0; i < threadCount; ++i) {
         threadAttributes[i] = attributes;
-        threadAttributes[i].config.errorCorrection.buffer = errorCorrectionBuffer.data()+i*maxBoxArea;
+        // Each thread keeps its temporary memory across glyphs and calls to generate
+        threadAttributes[i].config.context = &threadContexts[i];
+        // With fewer glyphs than threads, the spare threads help generate each glyph in bands of rows
+        if (count > 0 && count < threadCount)
+            threadAttributes[i].config.threadCount = threadCount/count;
+        // The vectorized distance computation may differ in the last bits and depends on the CPU
+        if (deterministic)
+            threadAttributes[i].config.simd = false;
     }
 
-    Workload([this, glyphs, &threadAttributes, threadBufferSize](int i, int threadNo) -> bool {
+    Workload([this, glyphs, &threadAttributes, &glyphOffsets, threadBufferSize](int i, int threadNo) -> bool {
         const GlyphGeometry &glyph = glyphs[i];
         if (!glyph.isWhitespace()) {
             int l, b, w, h;
             glyph.getBoxRect(l, b, w, h);
-            msdfgen::BitmapRef<T, N> glyphBitmap(glyphBuffer.data()+threadNo*threadBufferSize, w, h);
+            msdfgen::BitmapRef<T, N> glyphBitmap(glyphBuffer.data()+(deterministic ? glyphOffsets[i] : threadNo*threadBufferSize), w, h);
             GEN_FN(glyphBitmap, glyph, threadAttributes[threadNo]);
-            storage.put(l, b, msdfgen::BitmapConstRef<T, N>(glyphBitmap));
+            if (!deterministic)
+                storage.put(l, b, msdfgen::BitmapConstRef<T, N>(glyphBitmap));
         }
         return true;
     }, count).finish(threadCount);
+
+    // Boxes may share border pixels (negative padding), whose final value is determined by the glyph put last
+    if (deterministic) {
+        for (int i = 0; i < count; ++i) {
+            if (!glyphs[i].isWhitespace()) {
+                int l, b, w, h;
+                glyphs[i].getBoxRect(l, b, w, h);
+                storage.put(l, b, msdfgen::BitmapConstRef<T, N>(glyphBuffer.data()+glyphOffsets[i], w, h));
+            }
+        }
+    }
 }
 
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
@@ -69,6 +96,11 @@ void ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::setThreadCount(int thr
     this->threadCount = threadCount;
 }
 
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::setDeterministic(bool deterministic) {
+    this->deterministic = deterministic;
+}
+
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
 const AtlasStorage & ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::atlasStorage() const {
     return storage;
@@ -0,0 +1,207 @@
+
+#include "ShapeCache.h"
+
+#include <cstdio>
+#include <cstring>
+
+#define SHAPE_CACHE_SIGNATURE "MSDFSHC1"
+#define SHAPE_CACHE_SIGNATURE_LENGTH 8
+
+namespace msdf_atlas {
+
+template <typename T>
+static bool readValue(T &value, FILE *f) {
+    return fread(&value, sizeof(T), 1, f) == 1;
+}
+
+template <typename T>
+static bool writeValue(const T &value, FILE *f) {
+    return fwrite(&value, sizeof(T), 1, f) == 1;
+}
+
+/// Reads count elements unless the remaining size of the file (of fileSize bytes) is too small to hold them, so that corrupt counts cannot cause huge allocations
+template <typename T>
+static bool readArray(std::vector<T> &array, int count, FILE *f, long fileSize) {
+    long position = ftell(f);
+    if (count < 0 || position < 0 || (unsigned long long) count*sizeof(T) > (unsigned long long) (fileSize-position))
+        return false;
+    array.resize(count);
+    return !count || fread(array.data(), sizeof(T), count, f) == (size_t) count;
+}
+
+template <typename T>
+static bool writeArray(const std::vector<T> &array, FILE *f) {
+    return array.empty() || fwrite(array.data(), sizeof(T), array.size(), f) == array.size();
+}
+
+bool ShapeCache::hashFontFile(unsigned long long &fontHash, const char *filename) {
+    FILE *f = fopen(filename, "rb");
+    if (!f)
+        return false;
+    // 64-bit FNV-1a
+    unsigned long long hash = 14695981039346656037ull;
+    unsigned char buffer[65536];
+    for (size_t length; (length = fread(buffer, 1, sizeof(buffer), f));)
+        for (size_t i = 0; i < length; ++i)
+            hash = (hash^buffer[i])*1099511628211ull;
+    bool success = !ferror(f);
+    fclose(f);
+    fontHash = hash;
+    return success;
+}
+
+bool ShapeCache::Key::operator<(const Key &other) const {
+    if (fontHash != other.fontHash)
+        return fontHash < other.fontHash;
+    if (glyphIndex != other.glyphIndex)
+        return glyphIndex < other.glyphIndex;
+    return resolved < other.resolved;
+}
+
+bool ShapeCache::validateEntry(const Entry &entry) {
+    size_t edgeCount = 0, pointCount = 0;
+    for (int contourEdges : entry.contours) {
+        if (contourEdges < 0)
+            return false;
+        edgeCount += contourEdges;
+    }
+    for (unsigned char edgePoints : entry.edges) {
+        if (edgePoints < 2 || edgePoints > 4)
+            return false;
+        pointCount += edgePoints;
+    }
+    return edgeCount == entry.edges.size() && pointCount == entry.points.size();
+}
+
+bool ShapeCache::load(const char *filename) {
+    FILE *f = fopen(filename, "rb");
+    if (!f)
+        return false;
+    long fileSize = -1;
+    if (!fseek(f, 0, SEEK_END)) {
+        fileSize = ftell(f);
+        rewind(f);
+    }
+    std::map<Key, Entry> loadedEntries;
+    char signature[SHAPE_CACHE_SIGNATURE_LENGTH];
+    int entryCount = 0;
+    bool success = fileSize >= 0 && fread(signature, 1, SHAPE_CACHE_SIGNATURE_LENGTH, f) == SHAPE_CACHE_SIGNATURE_LENGTH && !memcmp(signature, SHAPE_CACHE_SIGNATURE, SHAPE_CACHE_SIGNATURE_LENGTH) && readValue(entryCount, f) && entryCount >= 0;
+    for (int i = 0; success && i < entryCount; ++i) {
+        Key key = { };
+        Entry entry = { };
+        unsigned char resolved = 0, inverseYAxis = 0;
+        int contourCount = 0, edgeCount = 0, pointCount = 0;
+        success = (
+            readValue(key.fontHash, f) && readValue(key.glyphIndex, f) && readValue(resolved, f) &&
+            readValue(entry.advance, f) && readValue(inverseYAxis, f) &&
+            readValue(contourCount, f) && readValue(edgeCount, f) && readValue(pointCount, f) &&
+            readArray(entry.contours, contourCount, f, fileSize) && readArray(entry.edges, edgeCount, f, fileSize) && readArray(entry.points, pointCount, f, fileSize)
+        );
+        key.resolved = resolved != 0;
+        entry.inverseYAxis = inverseYAxis != 0;
+        if (success && !validateEntry(entry))
+            success = false;
+        if (success)
+            loadedEntries[key] = (Entry &&) entry;
+    }
+    fclose(f);
+    if (!success)
+        return false;
+    entries = (std::map<Key, Entry> &&) loadedEntries;
+    modified = false;
+    return true;
+}
+
+bool ShapeCache::save(const char *filename) const {
+    FILE *f = fopen(filename, "wb");
+    if (!f)
+        return false;
+    int entryCount = (int) entries.size();
+    bool success = fwrite(SHAPE_CACHE_SIGNATURE, 1, SHAPE_CACHE_SIGNATURE_LENGTH, f) == SHAPE_CACHE_SIGNATURE_LENGTH && writeValue(entryCount, f);
+    for (std::map<Key, Entry>::const_iterator it = entries.begin(); success && it != entries.end(); ++it) {
+        const Key &key = it->first;
+        const Entry &entry = it->second;
+        success = (
+            writeValue(key.fontHash, f) && writeValue(key.glyphIndex, f) && writeValue((unsigned char) key.resolved, f) &&
+            writeValue(entry.advance, f) && writeValue((unsigned char) entry.inverseYAxis, f) &&
+            writeValue((int) entry.contours.size(), f) && writeValue((int) entry.edges.size(), f) && writeValue((int) entry.points.size(), f) &&
+            writeArray(entry.contours, f) && writeArray(entry.edges, f) && writeArray(entry.points, f)
+        );
+    }
+    success &= !fclose(f);
+    if (success)
+        modified = false;
+    return success;
+}
+
+bool ShapeCache::get(msdfgen::Shape &shape, double &advance, unsigned long long fontHash, int glyphIndex, bool resolved, msdfgen::EdgeArena *edgeArena) const {
+    Key key = { fontHash, glyphIndex, resolved };
+    std::map<Key, Entry>::const_iterator it = entries.find(key);
+    if (it == entries.end())
+        return false;
+    const Entry &entry = it->second;
+    shape.contours.clear();
+    shape.inverseYAxis = entry.inverseYAxis;
+    const unsigned char *edge = entry.edges.data();
+    const msdfgen::Point2 *p = entry.points.data();
+    for (int edgeCount : entry.contours) {
+        msdfgen::Contour &contour = shape.addContour();
+        contour.edges.reserve(edgeCount);
+        for (int i = 0; i < edgeCount; p += *edge++, ++i) {
+            switch (*edge) {
+                case 2:
+                    if (edgeArena)
+                        edgeArena->addEdge(contour, p[0], p[1]);
+                    else
+                        contour.addEdge(msdfgen::EdgeHolder(p[0], p[1]));
+                    break;
+                case 3:
+                    if (edgeArena)
+                        edgeArena->addEdge(contour, p[0], p[1], p[2]);
+                    else
+                        contour.addEdge(msdfgen::EdgeHolder(p[0], p[1], p[2]));
+                    break;
+                case 4:
+                    if (edgeArena)
+                        edgeArena->addEdge(contour, p[0], p[1], p[2], p[3]);
+                    else
+                        contour.addEdge(msdfgen::EdgeHolder(p[0], p[1], p[2], p[3]));
+                    break;
+            }
+        }
+    }
+    advance = entry.advance;
+    return true;
+}
+
+void ShapeCache::set(unsigned long long fontHash, int glyphIndex, bool resolved, const msdfgen::Shape &shape, double advance) {
+    Key key = { fontHash, glyphIndex, resolved };
+    Entry &entry = entries[key];
+    entry.advance = advance;
+    entry.inverseYAxis = shape.inverseYAxis;
+    entry.contours.clear();
+    entry.edges.clear();
+    entry.points.clear();
+    for (const msdfgen::Contour &contour : shape.contours) {
+        entry.contours.push_back((int) contour.edges.size());
+        for (const msdfgen::EdgeHolder &edge : contour.edges) {
+            if (const msdfgen::LinearSegment *e = dynamic_cast<const msdfgen::LinearSegment *>(&*edge)) {
+                entry.edges.push_back(2);
+                entry.points.insert(entry.points.end(), e->p, e->p+2);
+            } else if (const msdfgen::QuadraticSegment *e = dynamic_cast<const msdfgen::QuadraticSegment *>(&*edge)) {
+                entry.edges.push_back(3);
+                entry.points.insert(entry.points.end(), e->p, e->p+3);
+            } else if (const msdfgen::CubicSegment *e = dynamic_cast<const msdfgen::CubicSegment *>(&*edge)) {
+                entry.edges.push_back(4);
+                entry.points.insert(entry.points.end(), e->p, e->p+4);
+            }
+        }
+    }
+    modified = true;
+}
+
+bool ShapeCache::isModified() const {
+    return modified;
+}
+
+}
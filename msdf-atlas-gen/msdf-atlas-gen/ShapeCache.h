@@ -0,0 +1,56 @@
+
+#pragma once
+
+#include <vector>
+#include <map>
+#include <msdfgen.h>
+
+namespace msdf_atlas {
+
+/**
+ * Stores the preprocessed shapes of glyphs, identified by the hash of their font file and their glyph index,
+ * so that they can be loaded again without decomposing their outlines and resolving their geometry.
+ * The cache file is binary and contains exact coordinates in the native byte order.
+ */
+class ShapeCache {
+
+public:
+    /// Computes the hash of the contents of a font file, which identifies the font in the cache
+    static bool hashFontFile(unsigned long long &fontHash, const char *filename);
+
+    /// Loads all entries from a cache file, returns false if it cannot be read
+    bool load(const char *filename);
+    /// Saves all entries to a cache file
+    bool save(const char *filename) const;
+    /// Outputs the cached shape and unscaled advance of a glyph, allocating its edges from edgeArena if not null, returns false if not present
+    bool get(msdfgen::Shape &shape, double &advance, unsigned long long fontHash, int glyphIndex, bool resolved, msdfgen::EdgeArena *edgeArena = nullptr) const;
+    /// Adds or replaces the shape of a glyph, resolved specifies whether its geometry has been resolved (resolveShapeGeometry)
+    void set(unsigned long long fontHash, int glyphIndex, bool resolved, const msdfgen::Shape &shape, double advance);
+    /// Returns true if entries have been set since the cache was last loaded or saved
+    bool isModified() const;
+
+private:
+    struct Key {
+        unsigned long long fontHash;
+        int glyphIndex;
+        bool resolved;
+        bool operator<(const Key &other) const;
+    };
+    struct Entry {
+        double advance;
+        bool inverseYAxis;
+        /// The number of edges of each contour
+        std::vector<int> contours;
+        /// The number of control points of each edge (2 = linear, 3 = quadratic, 4 = cubic)
+        std::vector<unsigned char> edges;
+        std::vector<msdfgen::Point2> points;
+    };
+
+    std::map<Key, Entry> entries;
+    mutable bool modified = false;
+
+    static bool validateEntry(const Entry &entry);
+
+};
+
+}
@@ -0,0 +1,19 @@
+
+#include "glyph-coloring.h"
+
+#include "Workload.h"
+
+#define LCG_MULTIPLIER 6364136223846793005ull
+#define LCG_INCREMENT 1442695040888963407ull
+
+namespace msdf_atlas {
+
+void edgeColoringBatch(GlyphGeometry *glyphs, int count, void (*fn)(msdfgen::Shape &, double, unsigned long long), double angleThreshold, unsigned long long seed, int threadCount) {
+    Workload([glyphs, fn, angleThreshold, seed](int i, int) -> bool {
+        unsigned long long glyphSeed = (LCG_MULTIPLIER*(seed^i)+LCG_INCREMENT)*!!seed;
+        glyphs[i].edgeColoring(fn, angleThreshold, glyphSeed);
+        return true;
+    }, count).finish(threadCount);
+}
+
+}
@@ -0,0 +1,13 @@
+
+#pragma once
+
+#include <msdfgen.h>
+#include "GlyphGeometry.h"
+
+namespace msdf_atlas {
+
+/// Applies edge coloring to the shapes of count glyphs, distributed among threadCount threads.
+/// Each glyph's seed is derived from seed and the glyph's index, so the result does not depend on the thread count.
+void edgeColoringBatch(GlyphGeometry *glyphs, int count, void (*fn)(msdfgen::Shape &, double, unsigned long long), double angleThreshold, unsigned long long seed, int threadCount);
+
+}
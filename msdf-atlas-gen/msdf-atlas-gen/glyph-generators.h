@@ -13,6 +13,8 @@ namespace msdf_atlas {
 
 /// Generates non-anti-aliased binary image of the glyph using scanline rasterization
 void scanlineGenerator(const msdfgen::BitmapRef<float, 1> &output, const GlyphGeometry &glyph, const GeneratorAttributes &attribs);
+/// Generates anti-aliased image of the glyph with the exact area coverage of each pixel
+void coverageGenerator(const msdfgen::BitmapRef<float, 1> &output, const GlyphGeometry &glyph, const GeneratorAttributes &attribs);
 /// Generates a true signed distance field of the glyph
 void sdfGenerator(const msdfgen::BitmapRef<float, 1> &output, const GlyphGeometry &glyph, const GeneratorAttributes &attribs);
 /// Generates a signed pseudo-distance field of the glyph
@@ -26,8 +26,6 @@ using namespace msdf_atlas;
 #define DEFAULT_PIXEL_RANGE 2.0
 #define SDF_ERROR_ESTIMATE_PRECISION 19
 #define GLYPH_FILL_RULE msdfgen::FILL_NONZERO
-#define LCG_MULTIPLIER 6364136223846793005ull
-#define LCG_INCREMENT 1442695040888963407ull
 
 #ifdef MSDFGEN_USE_SKIA
     #define TITLE_SUFFIX    " & Skia"
@@ -54,6 +52,8 @@ INPUT SPECIFICATION
       Specifies a name for the font that will be propagated into the output files as metadata.
   -and
       Separates multiple inputs to be combined into a single atlas.
+  -shapecache <filename>
+      Loads preprocessed glyph shapes from a cache file if it exists and adds the newly loaded ones to it.
 
 ATLAS CONFIGURATION
   -type <hardmask / softmask / sdf / psdf / msdf / mtsdf>
@@ -104,7 +104,9 @@ DISTANCE FIELD GENERATOR SETTINGS
   -errorimproveratio <ratio>
       Sets the minimum ratio between the pre-correction distance error and the post-correction distance error.
   -miterlimit <value>
-      Sets the miter limit that limits the extension of each glyph's bounding box due to very sharp corners. (psdf / msdf / mtsdf only))"
+      Sets the miter limit that limits the extension of each glyph's bounding box due to very sharp corners. (psdf / msdf / mtsdf only)
+  -quadratic <tolerance>
+      Converts cubic curves (e.g. of CFF fonts) to quadratic curves within the tolerance in pixels, which are faster to evaluate without SIMD or in single precision.)"
 #ifdef MSDFGEN_USE_SKIA
 R"(
   -overlap
@@ -123,8 +125,16 @@ R"(
 R"(
   -seed <N>
       Sets the initial seed for the edge coloring heuristic.
+  -singleprecision
+      Computes distances in single precision, which is faster and accurate enough for 8-bit atlases.
+  -sparse
+      Only computes distances of pixels within range of the glyph, the rest are saturated. Exact for sdf, approximate for psdf, msdf, and mtsdf.
   -threads <N>
       Sets the number of threads for the parallel computation. (0 = auto)
+  -deterministic
+      Makes the atlas independent of the number of threads and the CPU at the cost of memory and speed.
+  -verifydeterminism
+      Generates the atlas in deterministic mode with 1, 2, 4, and the specified number of threads and verifies that the results are identical.
 )";
 
 static const char *errorCorrectionHelpText = R"(
@@ -204,13 +214,16 @@ struct Configuration {
     double pxRange;
     double angleThreshold;
     double miterLimit;
+    double quadraticTolerance;
     void (*edgeColoring)(msdfgen::Shape &, double, unsigned long long);
-    bool expensiveColoring;
     unsigned long long coloringSeed;
     GeneratorAttributes generatorAttributes;
     bool preprocessGeometry;
     bool kerning;
     int threadCount;
+    bool deterministic;
+    bool verifyDeterminism;
+    const char *shapeCacheFilename;
     const char *arteryFontFilename;
     const char *imageFilename;
     const char *jsonFilename;
@@ -219,16 +232,58 @@ struct Configuration {
     const char *shadronPreviewText;
 };
 
+template <typename T, int N>
+static unsigned long long hashBitmap(const msdfgen::BitmapConstRef<T, N> &bitmap) {
+    // 64-bit FNV-1a
+    unsigned long long hash = 14695981039346656037ull;
+    const unsigned char *data = reinterpret_cast<const unsigned char *>(bitmap.pixels);
+    for (size_t i = 0, size = sizeof(T)*N*bitmap.width*bitmap.height; i < size; ++i)
+        hash = (hash^data[i])*1099511628211ull;
+    return hash;
+}
+
+/// Generates the atlas again with 1, 2, and 4 threads and compares the results against expectedHash
+template <typename T, typename S, int N, GeneratorFunction<S, N> GEN_FN>
+static bool verifyDeterminism(const std::vector<GlyphGeometry> &glyphs, const Configuration &config, unsigned long long expectedHash) {
+    bool success = true;
+    const int threadCounts[] = { 1, 2, 4 };
+    printf("Atlas hash with %d thread(s): %016llx\n", config.threadCount, expectedHash);
+    for (int i = 0; i < int(sizeof(threadCounts)/sizeof(*threadCounts)); ++i) {
+        if (threadCounts[i] == config.threadCount)
+            continue;
+        ImmediateAtlasGenerator<S, N, GEN_FN, BitmapAtlasStorage<T, N> > generator(config.width, config.height);
+        generator.setAttributes(config.generatorAttributes);
+        generator.setThreadCount(threadCounts[i]);
+        generator.setDeterministic(true);
+        generator.generate(glyphs.data(), glyphs.size());
+        unsigned long long hash = hashBitmap((msdfgen::BitmapConstRef<T, N>) generator.atlasStorage());
+        printf("Atlas hash with %d thread(s): %016llx%s\n", threadCounts[i], hash, hash == expectedHash ? "" : " (mismatch)");
+        if (hash != expectedHash)
+            success = false;
+    }
+    return success;
+}
+
 template <typename T, typename S, int N, GeneratorFunction<S, N> GEN_FN>
 static bool makeAtlas(const std::vector<GlyphGeometry> &glyphs, const std::vector<FontGeometry> &fonts, const Configuration &config) {
     ImmediateAtlasGenerator<S, N, GEN_FN, BitmapAtlasStorage<T, N> > generator(config.width, config.height);
     generator.setAttributes(config.generatorAttributes);
     generator.setThreadCount(config.threadCount);
+    generator.setDeterministic(config.deterministic);
     generator.generate(glyphs.data(), glyphs.size());
     msdfgen::BitmapConstRef<T, N> bitmap = (msdfgen::BitmapConstRef<T, N>) generator.atlasStorage();
 
     bool success = true;
 
+    if (config.verifyDeterminism) {
+        if (verifyDeterminism<T, S, N, GEN_FN>(glyphs, config, hashBitmap(bitmap)))
+            puts("Atlas is identical for all thread counts.");
+        else {
+            success = false;
+            puts("Atlas differs between thread counts.");
+        }
+    }
+
     if (config.imageFilename) {
         if (saveImage(bitmap, config.imageFormat, config.imageFilename, config.yDirection))
             puts("Atlas image file saved.");
@@ -350,6 +405,11 @@ int main(int argc, const char * const *argv) {
             ++argPos;
             continue;
         }
+        ARG_CASE("-shapecache", 1) {
+            config.shapeCacheFilename = argv[++argPos];
+            ++argPos;
+            continue;
+        }
         ARG_CASE("-charset", 1) {
             fontInput.charsetFilename = argv[++argPos];
             fontInput.glyphIdentifierType = GlyphIdentifierType::UNICODE_CODEPOINT;
@@ -554,9 +614,9 @@ int main(int argc, const char * const *argv) {
             continue;
         }
         ARG_CASE("-coloringstrategy", 1) {
-            if (!strcmp(argv[argPos+1], "simple")) config.edgeColoring = msdfgen::edgeColoringSimple, config.expensiveColoring = false;
-            else if (!strcmp(argv[argPos+1], "inktrap")) config.edgeColoring = msdfgen::edgeColoringInkTrap, config.expensiveColoring = false;
-            else if (!strcmp(argv[argPos+1], "distance")) config.edgeColoring = msdfgen::edgeColoringByDistance, config.expensiveColoring = true;
+            if (!strcmp(argv[argPos+1], "simple")) config.edgeColoring = msdfgen::edgeColoringSimple;
+            else if (!strcmp(argv[argPos+1], "inktrap")) config.edgeColoring = msdfgen::edgeColoringInkTrap;
+            else if (!strcmp(argv[argPos+1], "distance")) config.edgeColoring = msdfgen::edgeColoringByDistance;
             else
                 puts("Unknown coloring strategy specified.");
             argPos += 2;
@@ -570,6 +630,14 @@ int main(int argc, const char * const *argv) {
             ++argPos;
             continue;
         }
+        ARG_CASE("-quadratic", 1) {
+            double tolerance;
+            if (!(parseDouble(tolerance, argv[++argPos]) && tolerance > 0))
+                ABORT("Invalid quadratic conversion tolerance. Use -quadratic <tolerance> with a positive real number.");
+            config.quadraticTolerance = tolerance;
+            ++argPos;
+            continue;
+        }
         ARG_CASE("-nokerning", 0) {
             config.kerning = false;
             ++argPos;
@@ -600,6 +668,16 @@ int main(int argc, const char * const *argv) {
             ++argPos;
             continue;
         }
+        ARG_CASE("-singleprecision", 0) {
+            config.generatorAttributes.config.singlePrecision = true;
+            ++argPos;
+            continue;
+        }
+        ARG_CASE("-sparse", 0) {
+            config.generatorAttributes.config.sparse = true;
+            ++argPos;
+            continue;
+        }
         ARG_CASE("-noscanline", 0) {
             config.generatorAttributes.scanlinePass = false;
             ++argPos;
@@ -624,6 +702,17 @@ int main(int argc, const char * const *argv) {
             argPos += 2;
             continue;
         }
+        ARG_CASE("-deterministic", 0) {
+            config.deterministic = true;
+            ++argPos;
+            continue;
+        }
+        ARG_CASE("-verifydeterminism", 0) {
+            config.deterministic = true;
+            config.verifyDeterminism = true;
+            ++argPos;
+            continue;
+        }
         ARG_CASE("-help", 0) {
             puts(helpText);
             return 0;
@@ -757,9 +846,14 @@ int main(int argc, const char * const *argv) {
     );
 
     // Load fonts
+    // The edges of all glyphs are allocated from a single arena, which must outlive them
+    msdfgen::EdgeArena edgeArena;
     std::vector<GlyphGeometry> glyphs;
     std::vector<FontGeometry> fonts;
     bool anyCodepointsAvailable = false;
+    ShapeCache shapeCache;
+    if (config.shapeCacheFilename)
+        shapeCache.load(config.shapeCacheFilename);
     {
         class FontHolder {
             msdfgen::FreetypeHandle *ft;
@@ -810,7 +904,10 @@ int main(int argc, const char * const *argv) {
             }
 
             // Load glyphs
-            FontGeometry fontGeometry(&glyphs);
+            FontGeometry fontGeometry(&glyphs, &edgeArena);
+            unsigned long long fontHash;
+            if (config.shapeCacheFilename && ShapeCache::hashFontFile(fontHash, fontInput.fontFilename))
+                fontGeometry.setShapeCache(&shapeCache, fontHash);
             int glyphsLoaded = -1;
             switch (fontInput.glyphIdentifierType) {
                 case GlyphIdentifierType::GLYPH_INDEX:
@@ -852,6 +949,8 @@ int main(int argc, const char * const *argv) {
             fonts.push_back((FontGeometry &&) fontGeometry);
         }
     }
+    if (config.shapeCacheFilename && shapeCache.isModified() && !shapeCache.save(config.shapeCacheFilename))
+        puts("Failed to save the shape cache file.");
     if (glyphs.empty())
         ABORT("No glyphs loaded.");
 
@@ -905,20 +1004,13 @@ int main(int argc, const char * const *argv) {
     if (!layoutOnly) {
 
         // Edge coloring
-        if (config.imageType == ImageType::MSDF || config.imageType == ImageType::MTSDF) {
-            if (config.expensiveColoring) {
-                Workload([&glyphs, &config](int i, int threadNo) -> bool {
-                    unsigned long long glyphSeed = (LCG_MULTIPLIER*(config.coloringSeed^i)+LCG_INCREMENT)*!!config.coloringSeed;
-                    glyphs[i].edgeColoring(config.edgeColoring, config.angleThreshold, glyphSeed);
-                    return true;
-                }, glyphs.size()).finish(config.threadCount);
-            } else {
-                unsigned long long glyphSeed = config.coloringSeed;
-                for (GlyphGeometry &glyph : glyphs) {
-                    glyphSeed *= LCG_MULTIPLIER;
-                    glyph.edgeColoring(config.edgeColoring, config.angleThreshold, glyphSeed);
-                }
-            }
+        if (config.imageType == ImageType::MSDF || config.imageType == ImageType::MTSDF)
+            edgeColoringBatch(glyphs.data(), (int) glyphs.size(), config.edgeColoring, config.angleThreshold, config.coloringSeed, config.threadCount);
+
+        // Cubic to quadratic conversion (after edge coloring, which it preserves)
+        if (config.quadraticTolerance > 0) {
+            for (GlyphGeometry &glyph : glyphs)
+                glyph.convertCubicsToQuadratics(config.quadraticTolerance);
         }
 
         bool success = false;
@@ -930,6 +1022,11 @@ int main(int argc, const char * const *argv) {
                     success = makeAtlas<byte, float, 1, scanlineGenerator>(glyphs, fonts, config);
                 break;
             case ImageType::SOFT_MASK:
+                if (floatingPointFormat)
+                    success = makeAtlas<float, float, 1, coverageGenerator>(glyphs, fonts, config);
+                else
+                    success = makeAtlas<byte, float, 1, coverageGenerator>(glyphs, fonts, config);
+                break;
             case ImageType::SDF:
                 if (floatingPointFormat)
                     success = makeAtlas<float, float, 1, sdfGenerator>(glyphs, fonts, config);
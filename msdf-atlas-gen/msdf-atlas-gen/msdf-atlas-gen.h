@@ -18,6 +18,7 @@
 #include "Rectangle.h"
 #include "Charset.h"
 #include "GlyphBox.h"
+#include "ShapeCache.h"
 #include "GlyphGeometry.h"
 #include "FontGeometry.h"
 #include "RectanglePacker.h"
@@ -32,6 +33,7 @@
 #include "ImmediateAtlasGenerator.h"
 #include "DynamicAtlas.h"
 #include "glyph-generators.h"
+#include "glyph-coloring.h"
 #include "image-encode.h"
 #include "image-save.h"
 #include "artery-font-export.h"
@@ -0,0 +1,58 @@
+
+#include "EdgeArena.h"
+
+#include <new>
+
+namespace msdfgen {
+
+// Alignment of allocations, sufficient for the edge segment classes
+#define EDGE_ARENA_ALIGNMENT 16
+
+EdgeArena::EdgeArena(size_t blockSize) : blockSize(blockSize), blockPosition(NULL), blockEnd(NULL), edges(0) { }
+
+EdgeArena::~EdgeArena() {
+    // The edge segment classes are trivially destructible apart from their virtual destructor, so only the memory is released
+    for (std::vector<char *>::iterator block = blocks.begin(); block != blocks.end(); ++block)
+        delete [] *block;
+}
+
+void * EdgeArena::allocate(size_t size) {
+    size = (size+EDGE_ARENA_ALIGNMENT-1)&~size_t(EDGE_ARENA_ALIGNMENT-1);
+    if (size_t(blockEnd-blockPosition) < size) {
+        size_t newBlockSize = size > blockSize ? size : blockSize;
+        // new[] of char only guarantees the fundamental alignment, so the first allocation is aligned manually
+        char *block = new char[newBlockSize+EDGE_ARENA_ALIGNMENT];
+        blocks.push_back(block);
+        blockPosition = block+(EDGE_ARENA_ALIGNMENT-size_t(block)%EDGE_ARENA_ALIGNMENT)%EDGE_ARENA_ALIGNMENT;
+        blockEnd = blockPosition+newBlockSize;
+    }
+    void *ptr = blockPosition;
+    blockPosition += size;
+    ++edges;
+    return ptr;
+}
+
+EdgeHolder & EdgeArena::addEdge(Contour &contour, EdgeSegment *segment) {
+    EdgeHolder &edge = contour.addEdge();
+    edge.edgeSegment = segment;
+    edge.ownsSegment = false;
+    return edge;
+}
+
+EdgeHolder & EdgeArena::addEdge(Contour &contour, Point2 p0, Point2 p1, EdgeColor edgeColor) {
+    return addEdge(contour, new(allocate(sizeof(LinearSegment))) LinearSegment(p0, p1, edgeColor));
+}
+
+EdgeHolder & EdgeArena::addEdge(Contour &contour, Point2 p0, Point2 p1, Point2 p2, EdgeColor edgeColor) {
+    return addEdge(contour, new(allocate(sizeof(QuadraticSegment))) QuadraticSegment(p0, p1, p2, edgeColor));
+}
+
+EdgeHolder & EdgeArena::addEdge(Contour &contour, Point2 p0, Point2 p1, Point2 p2, Point2 p3, EdgeColor edgeColor) {
+    return addEdge(contour, new(allocate(sizeof(CubicSegment))) CubicSegment(p0, p1, p2, p3, edgeColor));
+}
+
+size_t EdgeArena::edgeCount() const {
+    return edges;
+}
+
+}
@@ -0,0 +1,49 @@
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Vector2.h"
+#include "EdgeColor.h"
+#include "Contour.h"
+
+// Size in bytes of the memory blocks an EdgeArena allocates edge segments from.
+#ifndef MSDFGEN_EDGE_ARENA_BLOCK_SIZE
+#define MSDFGEN_EDGE_ARENA_BLOCK_SIZE 65536
+#endif
+
+namespace msdfgen {
+
+/// Allocates the edge segments of many shapes, e.g. all glyphs of a font, from large memory blocks
+/// instead of individually on the heap, and frees them all at once when it is destroyed.
+/// The edges it adds to contours are not owned by their EdgeHolders, so the arena must outlive the shapes they belong to,
+/// although copies of such shapes are independent of it. An arena must not be used by multiple threads at the same time.
+class EdgeArena {
+
+public:
+    explicit EdgeArena(size_t blockSize = MSDFGEN_EDGE_ARENA_BLOCK_SIZE);
+    ~EdgeArena();
+    /// Appends a linear edge allocated from the arena to the contour and returns its reference.
+    EdgeHolder & addEdge(Contour &contour, Point2 p0, Point2 p1, EdgeColor edgeColor = WHITE);
+    /// Appends a quadratic edge allocated from the arena to the contour and returns its reference.
+    EdgeHolder & addEdge(Contour &contour, Point2 p0, Point2 p1, Point2 p2, EdgeColor edgeColor = WHITE);
+    /// Appends a cubic edge allocated from the arena to the contour and returns its reference.
+    EdgeHolder & addEdge(Contour &contour, Point2 p0, Point2 p1, Point2 p2, Point2 p3, EdgeColor edgeColor = WHITE);
+    /// Returns the number of edge segments allocated from the arena.
+    size_t edgeCount() const;
+
+private:
+    size_t blockSize;
+    std::vector<char *> blocks;
+    char *blockPosition, *blockEnd;
+    size_t edges;
+
+    EdgeArena(const EdgeArena &);
+    EdgeArena & operator=(const EdgeArena &);
+
+    void * allocate(size_t size);
+    EdgeHolder & addEdge(Contour &contour, EdgeSegment *segment);
+
+};
+
+}
@@ -7,44 +7,54 @@ void EdgeHolder::swap(EdgeHolder &a, EdgeHolder &b) {
     EdgeSegment *tmp = a.edgeSegment;
     a.edgeSegment = b.edgeSegment;
     b.edgeSegment = tmp;
+    bool tmpOwns = a.ownsSegment;
+    a.ownsSegment = b.ownsSegment;
+    b.ownsSegment = tmpOwns;
 }
 
-EdgeHolder::EdgeHolder() : edgeSegment(NULL) { }
+EdgeHolder::EdgeHolder() : edgeSegment(NULL), ownsSegment(true) { }
 
-EdgeHolder::EdgeHolder(EdgeSegment *segment) : edgeSegment(segment) { }
+EdgeHolder::EdgeHolder(EdgeSegment *segment) : edgeSegment(segment), ownsSegment(true) { }
 
-EdgeHolder::EdgeHolder(Point2 p0, Point2 p1, EdgeColor edgeColor) : edgeSegment(new LinearSegment(p0, p1, edgeColor)) { }
+EdgeHolder::EdgeHolder(Point2 p0, Point2 p1, EdgeColor edgeColor) : edgeSegment(new LinearSegment(p0, p1, edgeColor)), ownsSegment(true) { }
 
-EdgeHolder::EdgeHolder(Point2 p0, Point2 p1, Point2 p2, EdgeColor edgeColor) : edgeSegment(new QuadraticSegment(p0, p1, p2, edgeColor)) { }
+EdgeHolder::EdgeHolder(Point2 p0, Point2 p1, Point2 p2, EdgeColor edgeColor) : edgeSegment(new QuadraticSegment(p0, p1, p2, edgeColor)), ownsSegment(true) { }
 
-EdgeHolder::EdgeHolder(Point2 p0, Point2 p1, Point2 p2, Point2 p3, EdgeColor edgeColor) : edgeSegment(new CubicSegment(p0, p1, p2, p3, edgeColor)) { }
+EdgeHolder::EdgeHolder(Point2 p0, Point2 p1, Point2 p2, Point2 p3, EdgeColor edgeColor) : edgeSegment(new CubicSegment(p0, p1, p2, p3, edgeColor)), ownsSegment(true) { }
 
-EdgeHolder::EdgeHolder(const EdgeHolder &orig) : edgeSegment(orig.edgeSegment ? orig.edgeSegment->clone() : NULL) { }
+EdgeHolder::EdgeHolder(const EdgeHolder &orig) : edgeSegment(orig.edgeSegment ? orig.edgeSegment->clone() : NULL), ownsSegment(true) { }
 
 #ifdef MSDFGEN_USE_CPP11
-EdgeHolder::EdgeHolder(EdgeHolder &&orig) : edgeSegment(orig.edgeSegment) {
+EdgeHolder::EdgeHolder(EdgeHolder &&orig) noexcept : edgeSegment(orig.edgeSegment), ownsSegment(orig.ownsSegment) {
     orig.edgeSegment = NULL;
+    orig.ownsSegment = true;
 }
 #endif
 
 EdgeHolder::~EdgeHolder() {
-    delete edgeSegment;
+    if (ownsSegment)
+        delete edgeSegment;
 }
 
 EdgeHolder & EdgeHolder::operator=(const EdgeHolder &orig) {
     if (this != &orig) {
-        delete edgeSegment;
+        if (ownsSegment)
+            delete edgeSegment;
         edgeSegment = orig.edgeSegment ? orig.edgeSegment->clone() : NULL;
+        ownsSegment = true;
     }
     return *this;
 }
 
 #ifdef MSDFGEN_USE_CPP11
-EdgeHolder & EdgeHolder::operator=(EdgeHolder &&orig) {
+EdgeHolder & EdgeHolder::operator=(EdgeHolder &&orig) noexcept {
     if (this != &orig) {
-        delete edgeSegment;
+        if (ownsSegment)
+            delete edgeSegment;
         edgeSegment = orig.edgeSegment;
+        ownsSegment = orig.ownsSegment;
         orig.edgeSegment = NULL;
+        orig.ownsSegment = true;
     }
     return *this;
 }
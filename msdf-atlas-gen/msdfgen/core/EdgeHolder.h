@@ -5,8 +5,13 @@
 
 namespace msdfgen {
 
+class EdgeArena;
+
 /// Container for a single edge of dynamic type.
+/// The edge segment is owned by the holder unless it was allocated by an EdgeArena, in which case the arena releases it.
+/// Copies always own a heap-allocated clone of the segment.
 class EdgeHolder {
+    friend class EdgeArena;
 
 public:
     /// Swaps the edges held by a and b.
@@ -19,12 +24,12 @@ public:
     EdgeHolder(Point2 p0, Point2 p1, Point2 p2, Point2 p3, EdgeColor edgeColor = WHITE);
     EdgeHolder(const EdgeHolder &orig);
 #ifdef MSDFGEN_USE_CPP11
-    EdgeHolder(EdgeHolder &&orig);
+    EdgeHolder(EdgeHolder &&orig) noexcept;
 #endif
     ~EdgeHolder();
     EdgeHolder & operator=(const EdgeHolder &orig);
 #ifdef MSDFGEN_USE_CPP11
-    EdgeHolder & operator=(EdgeHolder &&orig);
+    EdgeHolder & operator=(EdgeHolder &&orig) noexcept;
 #endif
     EdgeSegment & operator*();
     const EdgeSegment & operator*() const;
@@ -35,6 +40,7 @@ public:
 
 private:
     EdgeSegment *edgeSegment;
+    bool ownsSegment;
 
 };
 
@@ -0,0 +1,105 @@
+
+#include "FlatShape.h"
+
+#include "simd-distance.h"
+
+namespace msdfgen {
+
+FlatShape::FlatShape(const Shape &shape) : contours((int) shape.contours.size()) {
+    int edgeCount = shape.edgeCount();
+    types.reserve(edgeCount);
+    pointIndices.reserve(edgeCount);
+    colors.reserve(edgeCount);
+    contourIndices.reserve(edgeCount);
+    segments.reserve(edgeCount);
+    startPoints.reserve(edgeCount);
+    endPoints.reserve(edgeCount);
+    startDirections.reserve(edgeCount);
+    endDirections.reserve(edgeCount);
+    startBisectors.reserve(edgeCount);
+    endBisectors.reserve(edgeCount);
+    for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour) {
+        if (!contour->edges.empty()) {
+            const EdgeSegment *prevEdge = contour->edges.size() >= 2 ? *(contour->edges.end()-2) : *contour->edges.begin();
+            const EdgeSegment *curEdge = contour->edges.back();
+            for (std::vector<EdgeHolder>::const_iterator edge = contour->edges.begin(); edge != contour->edges.end(); ++edge) {
+                const EdgeSegment *nextEdge = *edge;
+                addEdge(prevEdge, curEdge, nextEdge, int(contour-shape.contours.begin()));
+                prevEdge = curEdge;
+                curEdge = nextEdge;
+            }
+        }
+    }
+}
+
+void FlatShape::addEdge(const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge, int contourIndex) {
+    if (const LinearSegment *linear = dynamic_cast<const LinearSegment *>(edge)) {
+        types.push_back(LINEAR_EDGE);
+        pointIndices.push_back((int) linearPoints.size());
+        linearPoints.insert(linearPoints.end(), linear->p, linear->p+2);
+        for (int i = 0; i < 2; ++i)
+            linearPointsF.push_back(Vector2f(linear->p[i]));
+    } else if (const QuadraticSegment *quadratic = dynamic_cast<const QuadraticSegment *>(edge)) {
+        types.push_back(QUADRATIC_EDGE);
+        pointIndices.push_back((int) quadraticPoints.size());
+        quadraticPoints.insert(quadraticPoints.end(), quadratic->p, quadratic->p+3);
+        for (int i = 0; i < 3; ++i)
+            quadraticPointsF.push_back(Vector2f(quadratic->p[i]));
+    } else if (const CubicSegment *cubic = dynamic_cast<const CubicSegment *>(edge)) {
+        types.push_back(CUBIC_EDGE);
+        pointIndices.push_back((int) cubicPoints.size());
+        cubicPoints.insert(cubicPoints.end(), cubic->p, cubic->p+4);
+        for (int i = 0; i < 4; ++i)
+            cubicPointsF.push_back(Vector2f(cubic->p[i]));
+        CubicCoefficients<Vector2> coefficients;
+        CubicCoefficients<Vector2f> coefficientsF;
+        computeCubicCoefficients(coefficients, cubic->p);
+        computeCubicCoefficients(coefficientsF, &cubicPointsF[cubicPointsF.size()-4]);
+        // Both precisions search from the same starting points
+        coefficientsF.searchStarts = coefficients.searchStarts;
+        cubicCoefficients.push_back(coefficients);
+        cubicCoefficientsF.push_back(coefficientsF);
+    } else {
+        types.push_back(GENERIC_EDGE);
+        pointIndices.push_back(-1);
+    }
+    colors.push_back(edge->color);
+    contourIndices.push_back(contourIndex);
+    segments.push_back(edge);
+    // Same expressions as in the edge selectors
+    Vector2 aDir = edge->direction(0).normalize(true);
+    Vector2 bDir = edge->direction(1).normalize(true);
+    startPoints.push_back(edge->point(0));
+    endPoints.push_back(edge->point(1));
+    startDirections.push_back(aDir);
+    endDirections.push_back(bDir);
+    startBisectors.push_back((prevEdge->direction(1).normalize(true)+aDir).normalize(true));
+    endBisectors.push_back((bDir+nextEdge->direction(0).normalize(true)).normalize(true));
+}
+
+void FlatShape::signedDistances(int edge, const double *x, const double *y, SignedDistance *distances, double *params) const {
+    switch (types[edge]) {
+        case LINEAR_EDGE:
+            linearSignedDistances(&linearPoints[pointIndices[edge]], x, y, distances, params);
+            break;
+        case QUADRATIC_EDGE:
+            quadraticSignedDistances(&quadraticPoints[pointIndices[edge]], x, y, distances, params);
+            break;
+        case CUBIC_EDGE:
+            cubicSignedDistances(&cubicPoints[pointIndices[edge]], cubicCoefficients[pointIndices[edge]>>2], x, y, distances, params);
+            break;
+        default:
+            for (int i = 0; i < MSDFGEN_SIMD_LANES; ++i)
+                distances[i] = segments[edge]->signedDistance(Point2(x[i], y[i]), params[i]);
+    }
+}
+
+int FlatShape::edgeCount() const {
+    return (int) types.size();
+}
+
+int FlatShape::contourCount() const {
+    return contours;
+}
+
+}
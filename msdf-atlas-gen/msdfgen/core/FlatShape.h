@@ -0,0 +1,111 @@
+
+#pragma once
+
+#include <vector>
+#include "Vector2.h"
+#include "Vector2f.hpp"
+#include "SignedDistance.h"
+#include "EdgeColor.h"
+#include "Shape.h"
+#include "edge-segment-kernels.hpp"
+
+namespace msdfgen {
+
+/// An immutable copy of a Shape's edges laid out for distance queries without virtual dispatch.
+/// The control points of linear, quadratic and cubic segments are stored in separate contiguous arrays,
+/// while the per-edge data used by the edge selectors (type, color, contour, endpoints, directions and bisectors)
+/// is stored in parallel arrays in the order in which ShapeDistanceFinder visits the edges. The coefficients of cubic segments are computed in advance.
+class FlatShape {
+
+public:
+    enum EdgeType {
+        LINEAR_EDGE,
+        QUADRATIC_EDGE,
+        CUBIC_EDGE,
+        /// An edge segment of another type, evaluated through its virtual methods.
+        GENERIC_EDGE
+    };
+
+    explicit FlatShape(const Shape &shape);
+    /// Returns the total number of edges.
+    int edgeCount() const;
+    /// Returns the number of contours of the original shape, including empty ones.
+    int contourCount() const;
+
+    /// Returns the minimum signed distance between origin and the edge, same as EdgeSegment::signedDistance.
+    /// Real is double, or float to evaluate linear, quadratic and cubic segments in single precision from a copy of their control points.
+    template <typename Real>
+    inline SignedDistance signedDistance(int edge, Point2 origin, double &param) const;
+    /// Computes the signed distances of the edge to MSDFGEN_SIMD_LANES points at once using the vectorized kernels. Requires simdDistanceSupported.
+    void signedDistances(int edge, const double *x, const double *y, SignedDistance *distances, double *params) const;
+
+    EdgeType type(int edge) const { return EdgeType(types[edge]); }
+    EdgeColor color(int edge) const { return colors[edge]; }
+    int contourIndex(int edge) const { return contourIndices[edge]; }
+    /// The edge segment of the original shape the edge was made from.
+    const EdgeSegment * segment(int edge) const { return segments[edge]; }
+    /// The edge's start point, equal to EdgeSegment::point(0).
+    Point2 startPoint(int edge) const { return startPoints[edge]; }
+    /// The edge's end point, equal to EdgeSegment::point(1).
+    Point2 endPoint(int edge) const { return endPoints[edge]; }
+    /// The normalized direction at the start of the edge.
+    Vector2 startDirection(int edge) const { return startDirections[edge]; }
+    /// The normalized direction at the end of the edge.
+    Vector2 endDirection(int edge) const { return endDirections[edge]; }
+    /// The bisector of the previous edge's end direction and the start direction, delimiting the domain of the start point's pseudo-distance.
+    Vector2 startBisector(int edge) const { return startBisectors[edge]; }
+    /// The bisector of the end direction and the next edge's start direction, delimiting the domain of the end point's pseudo-distance.
+    Vector2 endBisector(int edge) const { return endBisectors[edge]; }
+
+private:
+    int contours;
+    std::vector<unsigned char> types;
+    // Index of the edge's first control point in the array of its type
+    std::vector<int> pointIndices;
+    std::vector<EdgeColor> colors;
+    std::vector<int> contourIndices;
+    std::vector<const EdgeSegment *> segments;
+    std::vector<Point2> startPoints, endPoints;
+    std::vector<Vector2> startDirections, endDirections;
+    std::vector<Vector2> startBisectors, endBisectors;
+    // Control points, 2 per linear, 3 per quadratic, and 4 per cubic segment
+    std::vector<Point2> linearPoints, quadraticPoints, cubicPoints;
+    // The same control points in single precision
+    std::vector<Vector2f> linearPointsF, quadraticPointsF, cubicPointsF;
+    // Precomputed coefficients of each cubic segment, in the order of cubicPoints
+    std::vector<CubicCoefficients<Vector2> > cubicCoefficients;
+    std::vector<CubicCoefficients<Vector2f> > cubicCoefficientsF;
+
+    void addEdge(const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge, int contourIndex);
+
+};
+
+template <>
+inline SignedDistance FlatShape::signedDistance<double>(int edge, Point2 origin, double &param) const {
+    switch (types[edge]) {
+        case LINEAR_EDGE:
+            return linearSignedDistance(&linearPoints[pointIndices[edge]], origin, param);
+        case QUADRATIC_EDGE:
+            return quadraticSignedDistance(&quadraticPoints[pointIndices[edge]], origin, param);
+        case CUBIC_EDGE:
+            return cubicSignedDistance(&cubicPoints[pointIndices[edge]], cubicCoefficients[pointIndices[edge]>>2], origin, param);
+        default:
+            return segments[edge]->signedDistance(origin, param);
+    }
+}
+
+template <>
+inline SignedDistance FlatShape::signedDistance<float>(int edge, Point2 origin, double &param) const {
+    switch (types[edge]) {
+        case LINEAR_EDGE:
+            return linearSignedDistance(&linearPointsF[pointIndices[edge]], Vector2f(origin), param);
+        case QUADRATIC_EDGE:
+            return quadraticSignedDistance(&quadraticPointsF[pointIndices[edge]], Vector2f(origin), param);
+        case CUBIC_EDGE:
+            return cubicSignedDistance(&cubicPointsF[pointIndices[edge]], cubicCoefficientsF[pointIndices[edge]>>2], Vector2f(origin), param);
+        default:
+            return segments[edge]->signedDistance(origin, param);
+    }
+}
+
+}
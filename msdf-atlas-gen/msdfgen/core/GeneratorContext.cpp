@@ -0,0 +1,55 @@
+
+#include "GeneratorContext.h"
+
+namespace msdfgen {
+
+template <typename T>
+static T * reserveBuffer(std::vector<T> &buffer, int size) {
+    // The buffer only ever grows, so that it stops reallocating once it fits the largest bitmap
+    if ((int) buffer.size() < size)
+        buffer.resize(size);
+    return buffer.empty() ? NULL : &buffer[0];
+}
+
+byte * GeneratorContext::stencilBuffer(int size) {
+    return reserveBuffer(stencil, size);
+}
+
+byte * GeneratorContext::channelOrderBuffer(int size) {
+    return reserveBuffer(channelOrder, size);
+}
+
+char * GeneratorContext::matchMapBuffer(int size) {
+    return reserveBuffer(matchMap, size);
+}
+
+char * GeneratorContext::bandBuffer(int size) {
+    return reserveBuffer(bands, size);
+}
+
+float * GeneratorContext::coverageBuffer(int size) {
+    return reserveBuffer(coverage, size);
+}
+
+signed char * GeneratorContext::tileSignBuffer(int size) {
+    return reserveBuffer(tileSigns, size);
+}
+
+Shape::Bounds * GeneratorContext::edgeBoundsBuffer(int size) {
+    return reserveBuffer(edgeBounds, size);
+}
+
+const Shape::Bounds ** GeneratorContext::rowBoundsBuffer(int size) {
+    return reserveBuffer(rowBounds, size);
+}
+
+ScanlineSweep & GeneratorContext::scanlineSweep(const Shape &shape) {
+    sweep.reset(shape);
+    return sweep;
+}
+
+Scanline & GeneratorContext::scanline() {
+    return line;
+}
+
+}
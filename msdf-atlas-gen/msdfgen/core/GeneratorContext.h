@@ -0,0 +1,53 @@
+
+#pragma once
+
+#include <vector>
+#include "BitmapRef.hpp"
+#include "Shape.h"
+#include "Scanline.h"
+#include "ScanlineSweep.h"
+
+namespace msdfgen {
+
+/// Keeps the temporary memory of the generator, rasterization, sign correction and error correction functions between calls (see GeneratorConfig::context),
+/// so that when many bitmaps are generated in a row, such as the glyphs of an atlas, nothing is allocated once the buffers have grown large enough.
+/// A context may only be used by one call at a time. If the call is processed by multiple threads, only one of them uses its scanline sweep.
+class GeneratorContext {
+
+public:
+    /// Returns a buffer of at least size bytes for the error correction stencil. Its contents are undefined, as are those of the following buffers.
+    byte * stencilBuffer(int size);
+    /// Returns a buffer of at least size bytes for the channel order codes of error correction.
+    byte * channelOrderBuffer(int size);
+    /// Returns a buffer of at least size elements for the match map of multi-channel sign correction.
+    char * matchMapBuffer(int size);
+    /// Returns a buffer of at least size elements for the flags of ambiguous bands or rows in multi-channel sign correction.
+    char * bandBuffer(int size);
+    /// Returns a buffer of at least size elements for the area coverage accumulator.
+    float * coverageBuffer(int size);
+    /// Returns a buffer of at least size elements for the tile signs of sparse generation.
+    signed char * tileSignBuffer(int size);
+    /// Returns a buffer of at least size elements for the edge bounds of sparse generation.
+    Shape::Bounds * edgeBoundsBuffer(int size);
+    /// Returns a buffer of at least size elements for the edge bounds of a row of tiles in sparse generation.
+    const Shape::Bounds ** rowBoundsBuffer(int size);
+    /// Rebuilds the scanline sweep for the shape and returns it.
+    ScanlineSweep & scanlineSweep(const Shape &shape);
+    /// Returns the scanline to be populated by the scanline sweep.
+    Scanline & scanline();
+
+private:
+    std::vector<byte> stencil;
+    std::vector<byte> channelOrder;
+    std::vector<char> matchMap;
+    std::vector<char> bands;
+    std::vector<float> coverage;
+    std::vector<signed char> tileSigns;
+    std::vector<Shape::Bounds> edgeBounds;
+    std::vector<const Shape::Bounds *> rowBounds;
+    ScanlineSweep sweep;
+    Scanline line;
+
+};
+
+}
@@ -0,0 +1,110 @@
+
+#pragma once
+
+#include <vector>
+#include "Vector2.h"
+#include "edge-selectors.h"
+#include "contour-combiners.h"
+#include "FlatShape.h"
+#include "simd-distance.h"
+
+#ifndef MSDFGEN_GRID_FINDER_MIN_EDGES
+// Minimum number of edges of a shape for distance field generation to use GridShapeDistanceFinder.
+#define MSDFGEN_GRID_FINDER_MIN_EDGES 8
+#endif
+#ifndef MSDFGEN_TILE_SIZE
+// Width and height in pixels of the tiles which share a list of candidate edges during distance field generation. Must divide MSDFGEN_PARALLEL_BAND_HEIGHT.
+#define MSDFGEN_TILE_SIZE 8
+#endif
+#ifndef MSDFGEN_TILE_MAX_CELL_FRACTION
+// Maximum size of a tile relative to a grid cell for GridShapeDistanceFinder::setTile to build a separate candidate list for it.
+#define MSDFGEN_TILE_MAX_CELL_FRACTION .5
+#endif
+
+namespace msdfgen {
+
+/// Specifies which edge colors are distinguished by an edge selector. Single-channel selectors consider all edges regardless of their color.
+template <class EdgeSelector>
+struct EdgeSelectorChannels {
+    static int mask(EdgeColor) { return WHITE; }
+};
+
+template <>
+struct EdgeSelectorChannels<MultiDistanceSelector> {
+    static int mask(EdgeColor color) { return color; }
+};
+
+template <>
+struct EdgeSelectorChannels<MultiAndTrueDistanceSelector> {
+    static int mask(EdgeColor color) { return color; }
+};
+
+/// Finds the distance between a point and a Shape, producing the same result as ShapeDistanceFinder while only visiting edges that can affect it.
+/// A uniform grid is laid over the shape and each cell lazily builds a list of candidate edges. An edge is left out if a lower bound
+/// of any distance it can contribute (true distance or endpoint pseudo-distance) exceeds an upper bound of the nearest edge's distance
+/// for each of its contour's color channels anywhere in the cell. Candidates are visited in the original order, preserving tie-breaking.
+/// Edges are evaluated through a FlatShape, in single precision if Real is float.
+/// Queries outside of the grid fall back to visiting all edges, unless restricted to a tile (see setTile).
+template <class ContourCombiner, typename Real = double>
+class GridShapeDistanceFinder {
+
+public:
+    typedef typename ContourCombiner::DistanceType DistanceType;
+
+    // Passed shape object must persist until the distance finder is destroyed!
+    explicit GridShapeDistanceFinder(const Shape &shape);
+    /// Finds the distance from origin. Not thread-safe! Is fastest when subsequent queries are close together.
+    DistanceType distance(const Point2 &origin);
+    /// Finds the distances from count (at most MSDFGEN_SIMD_LANES) origins, computing the distance of each edge to all of them at once
+    /// using the vectorized kernels. Requires simdDistanceSupported and double precision. Is fastest when the origins are adjacent and subsequent batches are close together.
+    void distances(DistanceType *distances, const Point2 *origins, int count);
+    /// Restricts subsequent queries, which must lie within the rectangle between lowerLeft and upperRight (such as a tile of pixels),
+    /// to the edges that can affect the distance anywhere within it, selected the same way as for a grid cell.
+    /// Has no effect if the rectangle is not much smaller than a grid cell, whose candidates are used instead.
+    void setTile(const Point2 &lowerLeft, const Point2 &upperRight);
+    /// Lifts the restriction of setTile.
+    void clearTile();
+
+private:
+    struct EdgeEntry {
+        int channels;
+        // bounding box of the edge
+        double l, b, r, t;
+        // points of the edge that its computed distance never exceeds
+        Point2 samples[3];
+        int sampleCount;
+    };
+    struct Cell {
+        bool built;
+        std::vector<int> edges;
+    };
+
+    FlatShape flatShape;
+    ContourCombiner contourCombiner;
+    std::vector<typename ContourCombiner::EdgeSelectorType::EdgeCache> shapeEdgeCache;
+    std::vector<EdgeEntry> edges;
+    int contourCount;
+    Point2 gridOrigin;
+    double cellSize, invCellSize;
+    int columns, rows;
+    double tolerance;
+    std::vector<Cell> cells;
+    std::vector<double> contourBounds;
+    // State of the batch queries, one contour combiner and edge cache per lane
+    std::vector<ContourCombiner> laneCombiners;
+    std::vector<typename ContourCombiner::EdgeSelectorType::EdgeCache> laneEdgeCache;
+    std::vector<int> allEdges;
+    std::vector<int> batchEdges;
+    bool tiled;
+    std::vector<int> tileEdges;
+
+    void addEdge(int edge, const Point2 &origin);
+    void buildCell(Cell &cell, int column, int row);
+    void findCandidates(std::vector<int> &candidates, const Point2 corners[4]);
+    double edgeLowerBound(int edge, const Point2 corners[4]) const;
+
+};
+
+}
+
+#include "GridShapeDistanceFinder.hpp"
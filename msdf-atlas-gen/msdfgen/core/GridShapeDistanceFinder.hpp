@@ -0,0 +1,285 @@
+
+#include "GridShapeDistanceFinder.h"
+
+#include <cfloat>
+#include <algorithm>
+#include "arithmetics.hpp"
+#include "edge-segments.h"
+
+namespace msdfgen {
+
+template <class ContourCombiner, typename Real>
+GridShapeDistanceFinder<ContourCombiner, Real>::GridShapeDistanceFinder(const Shape &shape) : flatShape(shape), contourCombiner(shape), shapeEdgeCache(flatShape.edgeCount()), contourCount(flatShape.contourCount()), cellSize(1), invCellSize(1), columns(0), rows(0), tolerance(0), laneCombiners(MSDFGEN_SIMD_LANES, contourCombiner), tiled(false) {
+    edges.resize(flatShape.edgeCount());
+    for (int i = 0; i < (int) edges.size(); ++i) {
+        EdgeEntry &entry = edges[i];
+        const EdgeSegment *segment = flatShape.segment(i);
+        entry.channels = EdgeSelectorChannels<typename ContourCombiner::EdgeSelectorType>::mask(flatShape.color(i));
+        entry.l = DBL_MAX, entry.b = DBL_MAX, entry.r = -DBL_MAX, entry.t = -DBL_MAX;
+        segment->bound(entry.l, entry.b, entry.r, entry.t);
+        // The distance of a linear or quadratic segment is exact, the cubic search only guarantees not to exceed the endpoint distances
+        entry.samples[0] = flatShape.startPoint(i);
+        entry.samples[1] = flatShape.endPoint(i);
+        entry.sampleCount = 2;
+        if (flatShape.type(i) == FlatShape::LINEAR_EDGE || flatShape.type(i) == FlatShape::QUADRATIC_EDGE)
+            entry.samples[entry.sampleCount++] = segment->point(.5);
+    }
+    if (edges.empty())
+        return;
+
+    // The grid covers the shape's bounds with a margin, where most queries of distance field generation fall
+    Shape::Bounds bounds = shape.getBounds();
+    double extent = max(bounds.r-bounds.l, bounds.t-bounds.b);
+    if (!(extent > 0))
+        extent = 1;
+    double margin = .25*extent;
+    int resolution = (int) ceil(sqrt((double) edges.size()));
+    resolution = min(max(resolution, 1), 32);
+    cellSize = extent/resolution;
+    invCellSize = 1/cellSize;
+    gridOrigin = Point2(bounds.l-margin, bounds.b-margin);
+    columns = (int) ceil((bounds.r-bounds.l+2*margin)*invCellSize);
+    rows = (int) ceil((bounds.t-bounds.b+2*margin)*invCellSize);
+    // Absorbs rounding differences between the bounds computed here and the distances computed by the edge selectors
+    tolerance = (sizeof(Real) < sizeof(double) ? 1e-5 : 1e-9)*(extent+max(max(fabs(bounds.l), fabs(bounds.r)), max(fabs(bounds.b), fabs(bounds.t))));
+    Cell emptyCell = { false, std::vector<int>() };
+    cells.resize((size_t) columns*rows, emptyCell);
+    contourBounds.resize(3*contourCount);
+}
+
+template <class ContourCombiner, typename Real>
+double GridShapeDistanceFinder<ContourCombiner, Real>::edgeLowerBound(int edge, const Point2 corners[4]) const {
+    const EdgeEntry &entry = edges[edge];
+    // True distance is bounded by the distance to the edge's bounding box
+    double dx = max(0., max(entry.l-corners[2].x, corners[0].x-entry.r));
+    double dy = max(0., max(entry.b-corners[2].y, corners[0].y-entry.t));
+    double lowerBound = sqrt(dx*dx+dy*dy);
+    if (lowerBound <= tolerance)
+        return 0;
+
+    // Pseudo-distance at an endpoint is the distance to its tangent line, only contributed within the endpoint's domain
+    for (int endpoint = 0; endpoint < 2; ++endpoint) {
+        double maxDomain = -DBL_MAX, maxTs = -DBL_MAX, minPd = DBL_MAX, maxPd = -DBL_MAX;
+        for (int i = 0; i < 4; ++i) {
+            double domain, ts, pd;
+            if (endpoint == 0) {
+                Vector2 ap = corners[i]-flatShape.startPoint(edge);
+                domain = dotProduct(ap, flatShape.startBisector(edge));
+                ts = dotProduct(ap, -flatShape.startDirection(edge));
+                pd = crossProduct(ap, -flatShape.startDirection(edge));
+            } else {
+                Vector2 bp = corners[i]-flatShape.endPoint(edge);
+                domain = -dotProduct(bp, flatShape.endBisector(edge));
+                ts = dotProduct(bp, flatShape.endDirection(edge));
+                pd = crossProduct(bp, flatShape.endDirection(edge));
+            }
+            maxDomain = max(maxDomain, domain);
+            maxTs = max(maxTs, ts);
+            minPd = min(minPd, pd);
+            maxPd = max(maxPd, pd);
+        }
+        if (maxDomain > -tolerance && maxTs > -tolerance) {
+            if (minPd <= tolerance && maxPd >= -tolerance)
+                return 0;
+            lowerBound = min(lowerBound, min(fabs(minPd), fabs(maxPd)));
+        }
+    }
+    return lowerBound;
+}
+
+template <class ContourCombiner, typename Real>
+void GridShapeDistanceFinder<ContourCombiner, Real>::buildCell(Cell &cell, int column, int row) {
+    double pad = 1e-6*cellSize;
+    Point2 corners[4] = {
+        Point2(gridOrigin.x+column*cellSize-pad, gridOrigin.y+row*cellSize-pad),
+        Point2(gridOrigin.x+(column+1)*cellSize+pad, gridOrigin.y+row*cellSize-pad),
+        Point2(gridOrigin.x+(column+1)*cellSize+pad, gridOrigin.y+(row+1)*cellSize+pad),
+        Point2(gridOrigin.x+column*cellSize-pad, gridOrigin.y+(row+1)*cellSize+pad)
+    };
+    findCandidates(cell.edges, corners);
+    cell.built = true;
+}
+
+template <class ContourCombiner, typename Real>
+void GridShapeDistanceFinder<ContourCombiner, Real>::findCandidates(std::vector<int> &candidates, const Point2 corners[4]) {
+    candidates.clear();
+    // Upper bound of the nearest distance within the cell for each contour and channel
+    for (std::vector<double>::iterator bound = contourBounds.begin(); bound != contourBounds.end(); ++bound)
+        *bound = DBL_MAX;
+    for (int i = 0; i < (int) edges.size(); ++i) {
+        const EdgeEntry &entry = edges[i];
+        double upperBound = DBL_MAX;
+        for (int j = 0; j < entry.sampleCount; ++j) {
+            double farthest = 0;
+            for (int k = 0; k < 4; ++k)
+                farthest = max(farthest, (corners[k]-entry.samples[j]).length());
+            upperBound = min(upperBound, farthest);
+        }
+        double *bounds = &contourBounds[3*flatShape.contourIndex(i)];
+        if (entry.channels&RED)
+            bounds[0] = min(bounds[0], upperBound);
+        if (entry.channels&GREEN)
+            bounds[1] = min(bounds[1], upperBound);
+        if (entry.channels&BLUE)
+            bounds[2] = min(bounds[2], upperBound);
+    }
+
+    for (int i = 0; i < (int) edges.size(); ++i) {
+        const EdgeEntry &entry = edges[i];
+        const double *bounds = &contourBounds[3*flatShape.contourIndex(i)];
+        double upperBound = -DBL_MAX;
+        if (entry.channels&RED)
+            upperBound = max(upperBound, bounds[0]);
+        if (entry.channels&GREEN)
+            upperBound = max(upperBound, bounds[1]);
+        if (entry.channels&BLUE)
+            upperBound = max(upperBound, bounds[2]);
+        if (entry.channels && edgeLowerBound(i, corners) <= upperBound+tolerance)
+            candidates.push_back(i);
+    }
+}
+
+template <class ContourCombiner, typename Real>
+void GridShapeDistanceFinder<ContourCombiner, Real>::setTile(const Point2 &lowerLeft, const Point2 &upperRight) {
+    tiled = false;
+    if (edges.empty() || max(upperRight.x-lowerLeft.x, upperRight.y-lowerLeft.y) > MSDFGEN_TILE_MAX_CELL_FRACTION*cellSize)
+        return;
+    double pad = 1e-6*cellSize;
+    Point2 corners[4] = {
+        Point2(lowerLeft.x-pad, lowerLeft.y-pad),
+        Point2(upperRight.x+pad, lowerLeft.y-pad),
+        Point2(upperRight.x+pad, upperRight.y+pad),
+        Point2(lowerLeft.x-pad, upperRight.y+pad)
+    };
+    findCandidates(tileEdges, corners);
+    tiled = true;
+}
+
+template <class ContourCombiner, typename Real>
+void GridShapeDistanceFinder<ContourCombiner, Real>::clearTile() {
+    tiled = false;
+}
+
+template <class ContourCombiner, typename Real>
+void GridShapeDistanceFinder<ContourCombiner, Real>::addEdge(int edge, const Point2 &origin) {
+    typename ContourCombiner::EdgeSelectorType &edgeSelector = contourCombiner.edgeSelector(flatShape.contourIndex(edge));
+    if (edgeSelector.needsEdgeDistance(shapeEdgeCache[edge], flatShape, edge)) {
+        double param;
+        SignedDistance distance = flatShape.signedDistance<Real>(edge, origin, param);
+        edgeSelector.addEdgeDistance(shapeEdgeCache[edge], flatShape, edge, distance, param);
+    }
+}
+
+template <class ContourCombiner, typename Real>
+typename GridShapeDistanceFinder<ContourCombiner, Real>::DistanceType GridShapeDistanceFinder<ContourCombiner, Real>::distance(const Point2 &origin) {
+    contourCombiner.reset(origin);
+
+    if (tiled) {
+        for (std::vector<int>::const_iterator index = tileEdges.begin(); index != tileEdges.end(); ++index)
+            addEdge(*index, origin);
+        return contourCombiner.distance();
+    }
+    double x = floor((origin.x-gridOrigin.x)*invCellSize);
+    double y = floor((origin.y-gridOrigin.y)*invCellSize);
+    if (x >= 0 && x < columns && y >= 0 && y < rows) {
+        int column = (int) x, row = (int) y;
+        Cell &cell = cells[row*columns+column];
+        if (!cell.built)
+            buildCell(cell, column, row);
+        for (std::vector<int>::const_iterator index = cell.edges.begin(); index != cell.edges.end(); ++index)
+            addEdge(*index, origin);
+    } else {
+        for (int i = 0; i < (int) edges.size(); ++i)
+            addEdge(i, origin);
+    }
+
+    return contourCombiner.distance();
+}
+
+template <class ContourCombiner, typename Real>
+void GridShapeDistanceFinder<ContourCombiner, Real>::distances(DistanceType *distances, const Point2 *origins, int count) {
+    typedef typename ContourCombiner::EdgeSelectorType EdgeSelector;
+    int edgeCount = (int) edges.size();
+    if (laneEdgeCache.empty()) {
+        laneEdgeCache.resize((size_t) MSDFGEN_SIMD_LANES*edgeCount);
+        allEdges.resize(edgeCount);
+        for (int i = 0; i < edgeCount; ++i)
+            allEdges[i] = i;
+    }
+
+    // Unused lanes repeat the last origin
+    double x[MSDFGEN_SIMD_LANES], y[MSDFGEN_SIMD_LANES];
+    for (int lane = 0; lane < MSDFGEN_SIMD_LANES; ++lane) {
+        const Point2 &origin = origins[min(lane, count-1)];
+        x[lane] = origin.x, y[lane] = origin.y;
+    }
+    for (int lane = 0; lane < count; ++lane)
+        laneCombiners[lane].reset(origins[lane]);
+
+    // The union of the candidate edges of the origins' cells, in original order
+    const std::vector<int> *candidates = tiled ? &tileEdges : NULL;
+    const std::vector<int> *cellEdges[MSDFGEN_SIMD_LANES];
+    int cellCount = 0;
+    for (int lane = 0; !tiled && lane < count; ++lane) {
+        double cx = floor((origins[lane].x-gridOrigin.x)*invCellSize);
+        double cy = floor((origins[lane].y-gridOrigin.y)*invCellSize);
+        if (!(cx >= 0 && cx < columns && cy >= 0 && cy < rows)) {
+            candidates = &allEdges;
+            break;
+        }
+        int column = (int) cx, row = (int) cy;
+        Cell &cell = cells[row*columns+column];
+        if (!cell.built)
+            buildCell(cell, column, row);
+        if (std::find(cellEdges, cellEdges+cellCount, &cell.edges) == cellEdges+cellCount)
+            cellEdges[cellCount++] = &cell.edges;
+    }
+    if (!candidates) {
+        if (cellCount == 1)
+            candidates = cellEdges[0];
+        else {
+            batchEdges.clear();
+            for (int i = 0; i < cellCount; ++i)
+                batchEdges.insert(batchEdges.end(), cellEdges[i]->begin(), cellEdges[i]->end());
+            std::sort(batchEdges.begin(), batchEdges.end());
+            batchEdges.erase(std::unique(batchEdges.begin(), batchEdges.end()), batchEdges.end());
+            candidates = &batchEdges;
+        }
+    }
+
+    for (std::vector<int>::const_iterator index = candidates->begin(); index != candidates->end(); ++index) {
+        int edge = *index;
+        int contourIndex = flatShape.contourIndex(edge);
+        EdgeSelector *selectors[MSDFGEN_SIMD_LANES];
+        int mask = 0;
+        for (int lane = 0; lane < count; ++lane) {
+            selectors[lane] = &laneCombiners[lane].edgeSelector(contourIndex);
+            if (selectors[lane]->needsEdgeDistance(laneEdgeCache[(size_t) lane*edgeCount+edge], flatShape, edge))
+                mask |= 1<<lane;
+        }
+        if (!mask)
+            continue;
+        if (!(mask&(mask-1))) {
+            // A single lane is cheaper to evaluate with the scalar kernel
+            int lane = 0;
+            while (!(mask&1<<lane))
+                ++lane;
+            double param;
+            SignedDistance distance = flatShape.signedDistance<double>(edge, origins[lane], param);
+            selectors[lane]->addEdgeDistance(laneEdgeCache[(size_t) lane*edgeCount+edge], flatShape, edge, distance, param);
+        } else {
+            SignedDistance laneDistances[MSDFGEN_SIMD_LANES];
+            double params[MSDFGEN_SIMD_LANES];
+            flatShape.signedDistances(edge, x, y, laneDistances, params);
+            for (int lane = 0; lane < count; ++lane) {
+                if (mask&1<<lane)
+                    selectors[lane]->addEdgeDistance(laneEdgeCache[(size_t) lane*edgeCount+edge], flatShape, edge, laneDistances[lane], params[lane]);
+            }
+        }
+    }
+
+    for (int lane = 0; lane < count; ++lane)
+        distances[lane] = laneCombiners[lane].distance();
+}
+
+}
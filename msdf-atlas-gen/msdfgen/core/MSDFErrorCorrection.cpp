@@ -2,14 +2,16 @@
 #include "MSDFErrorCorrection.h"
 
 #include <cstring>
+#include <vector>
 #include "arithmetics.hpp"
 #include "equation-solver.h"
 #include "EdgeColor.h"
 #include "bitmap-interpolation.hpp"
 #include "edge-selectors.h"
 #include "contour-combiners.h"
-#include "ShapeDistanceFinder.h"
+#include "GridShapeDistanceFinder.h"
 #include "generator-config.h"
+#include "ThreadPool.h"
 
 namespace msdfgen {
 
@@ -19,6 +21,11 @@ namespace msdfgen {
 #define CLASSIFIER_FLAG_CANDIDATE 0x01
 #define CLASSIFIER_FLAG_ARTIFACT 0x02
 
+// Relative margin by which a difference of two color channels must exceed 0 for its sign to be reliable in the artifact tests despite rounding
+#define CHANNEL_ORDER_EPSILON .000244140625f
+// Bit mask of the channel order code of a texel (see channelOrderCode) which is set for each channel pair whose order is uncertain
+#define CHANNEL_ORDER_UNCERTAIN 0x15
+
 const double ErrorCorrectionConfig::defaultMinDeviationRatio = 1.11111111111111111;
 const double ErrorCorrectionConfig::defaultMinImproveRatio = 1.11111111111111111;
 
@@ -93,20 +100,26 @@ public:
     inline ArtifactClassifier classifier(const Vector2 &direction, double span) {
         return ArtifactClassifier(this, direction, span);
     }
+    /// Restricts the exact distance evaluations to the edges that can affect the rectangle between lowerLeft and upperRight.
+    inline void setTile(const Point2 &lowerLeft, const Point2 &upperRight) {
+        distanceFinder.setTile(lowerLeft, upperRight);
+    }
 private:
-    ShapeDistanceFinder<ContourCombiner<PseudoDistanceSelector> > distanceFinder;
+    GridShapeDistanceFinder<ContourCombiner<PseudoDistanceSelector> > distanceFinder;
     BitmapConstRef<float, N> sdf;
     double invRange;
     Vector2 texelSize;
     double minImproveRatio;
 };
 
-MSDFErrorCorrection::MSDFErrorCorrection() { }
+MSDFErrorCorrection::MSDFErrorCorrection() : threadCount(MSDFGEN_DEFAULT_THREAD_COUNT), context(NULL) { }
 
 MSDFErrorCorrection::MSDFErrorCorrection(const BitmapRef<byte, 1> &stencil, const Projection &projection, double range) : stencil(stencil), projection(projection) {
     invRange = 1/range;
     minDeviationRatio = ErrorCorrectionConfig::defaultMinDeviationRatio;
     minImproveRatio = ErrorCorrectionConfig::defaultMinImproveRatio;
+    threadCount = MSDFGEN_DEFAULT_THREAD_COUNT;
+    context = NULL;
     memset(stencil.pixels, 0, sizeof(byte)*stencil.width*stencil.height);
 }
 
@@ -118,6 +131,14 @@ void MSDFErrorCorrection::setMinImproveRatio(double minImproveRatio) {
     this->minImproveRatio = minImproveRatio;
 }
 
+void MSDFErrorCorrection::setThreadCount(int threadCount) {
+    this->threadCount = threadCount;
+}
+
+void MSDFErrorCorrection::setContext(GeneratorContext *context) {
+    this->context = context;
+}
+
 void MSDFErrorCorrection::protectCorners(const Shape &shape) {
     for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour)
         if (!contour->edges.empty()) {
@@ -189,10 +210,16 @@ static void protectExtremeChannels(byte *stencil, const float *msd, float m, int
 
 template <int N>
 void MSDFErrorCorrection::protectEdges(const BitmapConstRef<float, N> &sdf) {
+    protectEdges(sdf, 0, sdf.height);
+}
+
+template <int N>
+void MSDFErrorCorrection::protectEdges(const BitmapConstRef<float, N> &sdf, int y0, int y1) {
     float radius;
+    int pairEnd = min(y1, sdf.height-1);
     // Horizontal texel pairs
     radius = float(PROTECTION_RADIUS_TOLERANCE*projection.unprojectVector(Vector2(invRange, 0)).length());
-    for (int y = 0; y < sdf.height; ++y) {
+    for (int y = y0; y < y1; ++y) {
         const float *left = sdf(0, y);
         const float *right = sdf(1, y);
         for (int x = 0; x < sdf.width-1; ++x) {
@@ -208,7 +235,7 @@ void MSDFErrorCorrection::protectEdges(const BitmapConstRef<float, N> &sdf) {
     }
     // Vertical texel pairs
     radius = float(PROTECTION_RADIUS_TOLERANCE*projection.unprojectVector(Vector2(0, invRange)).length());
-    for (int y = 0; y < sdf.height-1; ++y) {
+    for (int y = y0; y < pairEnd; ++y) {
         const float *bottom = sdf(0, y);
         const float *top = sdf(0, y+1);
         for (int x = 0; x < sdf.width; ++x) {
@@ -224,7 +251,7 @@ void MSDFErrorCorrection::protectEdges(const BitmapConstRef<float, N> &sdf) {
     }
     // Diagonal texel pairs
     radius = float(PROTECTION_RADIUS_TOLERANCE*projection.unprojectVector(Vector2(invRange)).length());
-    for (int y = 0; y < sdf.height-1; ++y) {
+    for (int y = y0; y < pairEnd; ++y) {
         const float *lb = sdf(0, y);
         const float *rb = sdf(1, y);
         const float *lt = sdf(0, y+1);
@@ -388,21 +415,84 @@ static bool hasDiagonalArtifact(const ArtifactClassifier &artifactClassifier, fl
     return false;
 }
 
+/// Encodes the order of each pair of color channels of texel msd in two bits (0 = equal, 1 = ascending, 2 = descending, 3 = uncertain).
+/// An artifact can only occur between texels where the order of a pair changes, because the tests look for points where the pair is equal.
+static byte channelOrderCode(const float *msd) {
+    float margin = CHANNEL_ORDER_EPSILON*(1.f+max(fabsf(msd[0]), max(fabsf(msd[1]), fabsf(msd[2]))));
+    float d[3] = { msd[1]-msd[0], msd[2]-msd[1], msd[0]-msd[2] };
+    byte code = 0;
+    for (int i = 0; i < 3; ++i)
+        code |= byte(((d[i] > margin)|(d[i] < -margin)<<1|(d[i] != 0 && !(fabsf(d[i]) > margin))*3)<<2*i);
+    return code;
+}
+
+/// Computes the channel order codes of row y.
 template <int N>
-void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, N> &sdf) {
-    // Compute the expected deltas between values of horizontally, vertically, and diagonally adjacent texels.
-    double hSpan = minDeviationRatio*projection.unprojectVector(Vector2(invRange, 0)).length();
-    double vSpan = minDeviationRatio*projection.unprojectVector(Vector2(0, invRange)).length();
-    double dSpan = minDeviationRatio*projection.unprojectVector(Vector2(invRange)).length();
-    // Inspect all texels.
-    for (int y = 0; y < sdf.height; ++y) {
+static void computeChannelOrder(byte *codes, const BitmapConstRef<float, N> &sdf, int y) {
+    const float *msd = sdf(0, y);
+    byte *code = codes+sdf.width*y;
+    for (int x = 0; x < sdf.width; ++x, msd += N)
+        code[x] = channelOrderCode(msd);
+}
+
+/// Computes the channel order codes of bands of rows. This is phase one of findErrors, which lets phase two skip texels whose whole neighborhood has the same channel order.
+template <int N>
+class ChannelOrderTask : public ThreadPool::Task {
+    BitmapConstRef<float, N> sdf;
+    byte *codes;
+public:
+    inline ChannelOrderTask(const BitmapConstRef<float, N> &sdf, byte *codes) : sdf(sdf), codes(codes) { }
+    void work(ThreadPool::Chunks &chunks) {
+        for (int band; chunks.next(band);) {
+            int yEnd = min((band+1)*MSDFGEN_PARALLEL_BAND_HEIGHT, sdf.height);
+            for (int y = band*MSDFGEN_PARALLEL_BAND_HEIGHT; y < yEnd; ++y)
+                computeChannelOrder(codes, sdf, y);
+        }
+    }
+};
+
+/// Returns true if no artifact can occur when texel x, y is interpolated with any of its 8 neighbors, because all of them have the same certain channel order.
+static bool hasUniformChannelOrder(const byte *codes, int width, int height, int x, int y) {
+    int l = max(x-1, 0), r = min(x+1, width-1);
+    int b = max(y-1, 0), t = min(y+1, height-1);
+    byte all = 0xff, any = 0;
+    for (int j = b; j <= t; ++j) {
+        const byte *code = codes+width*j;
+        for (int i = l; i <= r; ++i) {
+            all &= code[i];
+            any |= code[i];
+        }
+    }
+    return all == any && !(any&any>>1&CHANNEL_ORDER_UNCERTAIN);
+}
+
+/// Flags the texels of bands of rows based on analysis of the SDF only. Each texel's flags only depend on its own stencil value, so bands are independent.
+template <int N>
+class FindErrorsTask : public ThreadPool::Task {
+    BitmapRef<byte, 1> stencil;
+    BitmapConstRef<float, N> sdf;
+    const byte *codes;
+    double hSpan, vSpan, dSpan;
+public:
+    inline FindErrorsTask(const BitmapRef<byte, 1> &stencil, const BitmapConstRef<float, N> &sdf, const byte *codes, double hSpan, double vSpan, double dSpan) : stencil(stencil), sdf(sdf), codes(codes), hSpan(hSpan), vSpan(vSpan), dSpan(dSpan) { }
+    void work(ThreadPool::Chunks &chunks) {
+        for (int band; chunks.next(band);) {
+            int yEnd = min((band+1)*MSDFGEN_PARALLEL_BAND_HEIGHT, sdf.height);
+            for (int y = band*MSDFGEN_PARALLEL_BAND_HEIGHT; y < yEnd; ++y)
+                findRowErrors(y);
+        }
+    }
+    /// Flags the texels of row y. The codes of rows y-1 to y+1 must have been computed.
+    void findRowErrors(int y) {
         for (int x = 0; x < sdf.width; ++x) {
+            if (hasUniformChannelOrder(codes, sdf.width, sdf.height, x, y))
+                continue;
             const float *c = sdf(x, y);
             float cm = median(c[0], c[1], c[2]);
-            bool protectedFlag = (*stencil(x, y)&PROTECTED) != 0;
+            bool protectedFlag = (*stencil(x, y)&MSDFErrorCorrection::PROTECTED) != 0;
             const float *l = NULL, *b = NULL, *r = NULL, *t = NULL;
             // Mark current texel c with the error flag if an artifact occurs when it's interpolated with any of its 8 neighbors.
-            *stencil(x, y) |= (byte) (ERROR*(
+            *stencil(x, y) |= (byte) (MSDFErrorCorrection::ERROR*(
                 (x > 0 && ((l = sdf(x-1, y)), hasLinearArtifact(BaseArtifactClassifier(hSpan, protectedFlag), cm, c, l))) ||
                 (y > 0 && ((b = sdf(x, y-1)), hasLinearArtifact(BaseArtifactClassifier(vSpan, protectedFlag), cm, c, b))) ||
                 (x < sdf.width-1 && ((r = sdf(x+1, y)), hasLinearArtifact(BaseArtifactClassifier(hSpan, protectedFlag), cm, c, r))) ||
@@ -414,39 +504,63 @@ void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, N> &sdf) {
             ));
         }
     }
-}
+};
 
+/// Flags the texels of bands of rows based on analysis of the SDF and comparison with the exact shape distance.
+/// Each thread has its own distance checker. Bands are processed in tiles of MSDFGEN_TILE_SIZE texels, and the exact distances within a tile
+/// are only evaluated for the edges that can affect it, skipping tiles where no texel may produce an artifact candidate altogether.
 template <template <typename> class ContourCombiner, int N>
-void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, N> &sdf, const Shape &shape) {
-    // Compute the expected deltas between values of horizontally, vertically, and diagonally adjacent texels.
-    double hSpan = minDeviationRatio*projection.unprojectVector(Vector2(invRange, 0)).length();
-    double vSpan = minDeviationRatio*projection.unprojectVector(Vector2(0, invRange)).length();
-    double dSpan = minDeviationRatio*projection.unprojectVector(Vector2(invRange)).length();
-#ifdef MSDFGEN_USE_OPENMP
-    #pragma omp parallel
-#endif
-    {
+class FindShapeErrorsTask : public ThreadPool::Task {
+    BitmapRef<byte, 1> stencil;
+    BitmapConstRef<float, N> sdf;
+    const byte *codes;
+    const Shape &shape;
+    const Projection &projection;
+    double invRange, minImproveRatio;
+    double hSpan, vSpan, dSpan;
+public:
+    inline FindShapeErrorsTask(const BitmapRef<byte, 1> &stencil, const BitmapConstRef<float, N> &sdf, const byte *codes, const Shape &shape, const Projection &projection, double invRange, double minImproveRatio, double hSpan, double vSpan, double dSpan) : stencil(stencil), sdf(sdf), codes(codes), shape(shape), projection(projection), invRange(invRange), minImproveRatio(minImproveRatio), hSpan(hSpan), vSpan(vSpan), dSpan(dSpan) { }
+    void work(ThreadPool::Chunks &chunks) {
+        int band;
+        if (!chunks.next(band))
+            return;
         ShapeDistanceChecker<ContourCombiner, N> shapeDistanceChecker(sdf, shape, projection, invRange, minImproveRatio);
+        do {
+            int yEnd = min((band+1)*MSDFGEN_PARALLEL_BAND_HEIGHT, sdf.height);
+            for (int y0 = band*MSDFGEN_PARALLEL_BAND_HEIGHT; y0 < yEnd; y0 += MSDFGEN_TILE_SIZE) {
+                int y1 = min(y0+MSDFGEN_TILE_SIZE, yEnd);
+                for (int x0 = 0; x0 < sdf.width; x0 += MSDFGEN_TILE_SIZE) {
+                    int x1 = min(x0+MSDFGEN_TILE_SIZE, sdf.width);
+                    findTileErrors(shapeDistanceChecker, x0, y0, x1, y1);
+                }
+            }
+        } while (chunks.next(band));
+    }
+private:
+    void findTileErrors(ShapeDistanceChecker<ContourCombiner, N> &shapeDistanceChecker, int x0, int y0, int x1, int y1) {
+        bool tileSet = false;
         bool rightToLeft = false;
-        // Inspect all texels.
-#ifdef MSDFGEN_USE_OPENMP
-        #pragma omp for
-#endif
-        for (int y = 0; y < sdf.height; ++y) {
+        for (int y = y0; y < y1; ++y) {
             int row = shape.inverseYAxis ? sdf.height-y-1 : y;
-            for (int col = 0; col < sdf.width; ++col) {
-                int x = rightToLeft ? sdf.width-col-1 : col;
-                if ((*stencil(x, row)&ERROR))
+            for (int col = x0; col < x1; ++col) {
+                int x = rightToLeft ? x0+x1-col-1 : col;
+                if ((*stencil(x, row)&MSDFErrorCorrection::ERROR) || hasUniformChannelOrder(codes, sdf.width, sdf.height, x, row))
                     continue;
+                if (!tileSet) {
+                    // The distance is evaluated up to one texel away from the texels' centers
+                    Point2 a = projection.unproject(Point2(x0-1, y0-1)), b = projection.unproject(Point2(x1+1, y1+1));
+                    shapeDistanceChecker.setTile(Point2(min(a.x, b.x), min(a.y, b.y)), Point2(max(a.x, b.x), max(a.y, b.y)));
+                    tileSet = true;
+                }
                 const float *c = sdf(x, row);
                 shapeDistanceChecker.shapeCoord = projection.unproject(Point2(x+.5, y+.5));
                 shapeDistanceChecker.sdfCoord = Point2(x+.5, row+.5);
                 shapeDistanceChecker.msd = c;
-                shapeDistanceChecker.protectedFlag = (*stencil(x, row)&PROTECTED) != 0;
+                shapeDistanceChecker.protectedFlag = (*stencil(x, row)&MSDFErrorCorrection::PROTECTED) != 0;
                 float cm = median(c[0], c[1], c[2]);
                 const float *l = NULL, *b = NULL, *r = NULL, *t = NULL;
                 // Mark current texel c with the error flag if an artifact occurs when it's interpolated with any of its 8 neighbors.
-                *stencil(x, row) |= (byte) (ERROR*(
+                *stencil(x, row) |= (byte) (MSDFErrorCorrection::ERROR*(
                     (x > 0 && ((l = sdf(x-1, row)), hasLinearArtifact(shapeDistanceChecker.classifier(Vector2(-1, 0), hSpan), cm, c, l))) ||
                     (row > 0 && ((b = sdf(x, row-1)), hasLinearArtifact(shapeDistanceChecker.classifier(Vector2(0, -1), vSpan), cm, c, b))) ||
                     (x < sdf.width-1 && ((r = sdf(x+1, row)), hasLinearArtifact(shapeDistanceChecker.classifier(Vector2(+1, 0), hSpan), cm, c, r))) ||
@@ -457,15 +571,83 @@ void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, N> &sdf, const
                     (x < sdf.width-1 && row < sdf.height-1 && hasDiagonalArtifact(shapeDistanceChecker.classifier(Vector2(+1, +1), dSpan), cm, c, r, t, sdf(x+1, row+1)))
                 ));
             }
+            rightToLeft = !rightToLeft;
         }
     }
+};
+
+static int bandCount(int height) {
+    return (height+MSDFGEN_PARALLEL_BAND_HEIGHT-1)/MSDFGEN_PARALLEL_BAND_HEIGHT;
+}
+
+template <int N>
+void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, N> &sdf) {
+    // Compute the expected deltas between values of horizontally, vertically, and diagonally adjacent texels.
+    double hSpan = minDeviationRatio*projection.unprojectVector(Vector2(invRange, 0)).length();
+    double vSpan = minDeviationRatio*projection.unprojectVector(Vector2(0, invRange)).length();
+    double dSpan = minDeviationRatio*projection.unprojectVector(Vector2(invRange)).length();
+    if (sdf.width <= 0 || sdf.height <= 0)
+        return;
+    GeneratorContext localContext;
+    byte *codes = (context ? context : &localContext)->channelOrderBuffer(sdf.width*sdf.height);
+    // Phase one: classify the channel order of all texels.
+    {
+        ChannelOrderTask<N> task(sdf, codes);
+        ThreadPool::run(task, bandCount(sdf.height), threadCount);
+    }
+    // Phase two: inspect the texels where the channel order changes.
+    FindErrorsTask<N> task(stencil, sdf, codes, hSpan, vSpan, dSpan);
+    ThreadPool::run(task, bandCount(sdf.height), threadCount);
+}
+
+template <int N>
+void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, N> &sdf, int y0, int y1) {
+    if (!(y0 < y1))
+        return;
+    // Compute the expected deltas between values of horizontally, vertically, and diagonally adjacent texels.
+    double hSpan = minDeviationRatio*projection.unprojectVector(Vector2(invRange, 0)).length();
+    double vSpan = minDeviationRatio*projection.unprojectVector(Vector2(0, invRange)).length();
+    double dSpan = minDeviationRatio*projection.unprojectVector(Vector2(invRange)).length();
+    GeneratorContext localContext;
+    byte *codes = (context ? context : &localContext)->channelOrderBuffer(sdf.width*sdf.height);
+    // The codes of the adjacent rows are computed again, since there is no telling whether they were final at the previous call
+    for (int y = max(y0-1, 0), yEnd = min(y1+1, sdf.height); y < yEnd; ++y)
+        computeChannelOrder(codes, sdf, y);
+    FindErrorsTask<N> task(stencil, sdf, codes, hSpan, vSpan, dSpan);
+    for (int y = y0; y < y1; ++y)
+        task.findRowErrors(y);
+}
+
+template <template <typename> class ContourCombiner, int N>
+void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, N> &sdf, const Shape &shape) {
+    // Compute the expected deltas between values of horizontally, vertically, and diagonally adjacent texels.
+    double hSpan = minDeviationRatio*projection.unprojectVector(Vector2(invRange, 0)).length();
+    double vSpan = minDeviationRatio*projection.unprojectVector(Vector2(0, invRange)).length();
+    double dSpan = minDeviationRatio*projection.unprojectVector(Vector2(invRange)).length();
+    if (sdf.width <= 0 || sdf.height <= 0)
+        return;
+    GeneratorContext localContext;
+    byte *codes = (context ? context : &localContext)->channelOrderBuffer(sdf.width*sdf.height);
+    // Phase one: classify the channel order of all texels.
+    {
+        ChannelOrderTask<N> task(sdf, codes);
+        ThreadPool::run(task, bandCount(sdf.height), threadCount);
+    }
+    // Phase two: inspect the texels where the channel order changes, evaluating the exact shape distance where needed.
+    FindShapeErrorsTask<ContourCombiner, N> task(stencil, sdf, codes, shape, projection, invRange, minImproveRatio, hSpan, vSpan, dSpan);
+    ThreadPool::run(task, bandCount(sdf.height), threadCount);
 }
 
 template <int N>
 void MSDFErrorCorrection::apply(const BitmapRef<float, N> &sdf) const {
-    int texelCount = sdf.width*sdf.height;
-    const byte *mask = stencil.pixels;
-    float *texel = sdf.pixels;
+    apply(sdf, 0, sdf.height);
+}
+
+template <int N>
+void MSDFErrorCorrection::apply(const BitmapRef<float, N> &sdf, int y0, int y1) const {
+    int texelCount = sdf.width*(y1-y0);
+    const byte *mask = stencil(0, y0);
+    float *texel = sdf(0, y0);
     for (int i = 0; i < texelCount; ++i) {
         if (*mask&ERROR) {
             // Set all color channels to the median.
@@ -483,13 +665,19 @@ BitmapConstRef<byte, 1> MSDFErrorCorrection::getStencil() const {
 
 template void MSDFErrorCorrection::protectEdges(const BitmapConstRef<float, 3> &sdf);
 template void MSDFErrorCorrection::protectEdges(const BitmapConstRef<float, 4> &sdf);
+template void MSDFErrorCorrection::protectEdges(const BitmapConstRef<float, 3> &sdf, int y0, int y1);
+template void MSDFErrorCorrection::protectEdges(const BitmapConstRef<float, 4> &sdf, int y0, int y1);
 template void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, 3> &sdf);
 template void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, 4> &sdf);
+template void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, 3> &sdf, int y0, int y1);
+template void MSDFErrorCorrection::findErrors(const BitmapConstRef<float, 4> &sdf, int y0, int y1);
 template void MSDFErrorCorrection::findErrors<SimpleContourCombiner>(const BitmapConstRef<float, 3> &sdf, const Shape &shape);
 template void MSDFErrorCorrection::findErrors<SimpleContourCombiner>(const BitmapConstRef<float, 4> &sdf, const Shape &shape);
 template void MSDFErrorCorrection::findErrors<OverlappingContourCombiner>(const BitmapConstRef<float, 3> &sdf, const Shape &shape);
 template void MSDFErrorCorrection::findErrors<OverlappingContourCombiner>(const BitmapConstRef<float, 4> &sdf, const Shape &shape);
 template void MSDFErrorCorrection::apply(const BitmapRef<float, 3> &sdf) const;
 template void MSDFErrorCorrection::apply(const BitmapRef<float, 4> &sdf) const;
+template void MSDFErrorCorrection::apply(const BitmapRef<float, 3> &sdf, int y0, int y1) const;
+template void MSDFErrorCorrection::apply(const BitmapRef<float, 4> &sdf, int y0, int y1) const;
 
 }
@@ -4,6 +4,7 @@
 #include "Projection.h"
 #include "Shape.h"
 #include "BitmapRef.hpp"
+#include "GeneratorContext.h"
 
 namespace msdfgen {
 
@@ -25,22 +26,37 @@ public:
     void setMinDeviationRatio(double minDeviationRatio);
     /// Sets the minimum ratio between the pre-correction distance error and the post-correction distance error.
     void setMinImproveRatio(double minImproveRatio);
+    /// Sets the maximum number of threads used by findErrors (0 = one per CPU core).
+    void setThreadCount(int threadCount);
+    /// Sets a GeneratorContext whose buffers findErrors uses instead of allocating its own (NULL = none).
+    void setContext(GeneratorContext *context);
     /// Flags all texels that are interpolated at corners as protected.
     void protectCorners(const Shape &shape);
     /// Flags all texels that contribute to edges as protected.
     template <int N>
     void protectEdges(const BitmapConstRef<float, N> &sdf);
+    /// Flags the texels that contribute to edges within rows y0 to y1 (exclusive) and between row y1-1 and y1 as protected, which requires rows y0 to y1 to be final.
+    /// Allows rows to be processed as soon as they are final, with the same result as protectEdges once all rows have been covered.
+    template <int N>
+    void protectEdges(const BitmapConstRef<float, N> &sdf, int y0, int y1);
     /// Flags all texels as protected.
     void protectAll();
     /// Flags texels that are expected to cause interpolation artifacts based on analysis of the SDF only.
     template <int N>
     void findErrors(const BitmapConstRef<float, N> &sdf);
+    /// Flags texels of rows y0 to y1 (exclusive) like findErrors without the shape, on the calling thread. Rows y0-1 to y1 must be final
+    /// and the flags of rows y0 to y1-1 must otherwise be complete, i.e. their edges must have been protected.
+    template <int N>
+    void findErrors(const BitmapConstRef<float, N> &sdf, int y0, int y1);
     /// Flags texels that are expected to cause interpolation artifacts based on analysis of the SDF and comparison with the exact shape distance.
     template <template <typename> class ContourCombiner, int N>
     void findErrors(const BitmapConstRef<float, N> &sdf, const Shape &shape);
     /// Modifies the MSDF so that all texels with the error flag are converted to single-channel.
     template <int N>
     void apply(const BitmapRef<float, N> &sdf) const;
+    /// Applies the error flags of rows y0 to y1 (exclusive), which must no longer be read by findErrors for the adjacent rows.
+    template <int N>
+    void apply(const BitmapRef<float, N> &sdf, int y0, int y1) const;
     /// Returns the stencil in its current state (see Flags).
     BitmapConstRef<byte, 1> getStencil() const;
 
@@ -50,6 +66,8 @@ private:
     double invRange;
     double minDeviationRatio;
     double minImproveRatio;
+    int threadCount;
+    GeneratorContext *context;
 
 };
 
@@ -0,0 +1,67 @@
+
+#include "MSDFSignCorrection.h"
+
+#include "arithmetics.hpp"
+
+namespace msdfgen {
+
+MSDFSignCorrection::MSDFSignCorrection(char *matchMap, const Shape &shape, const Projection &projection, FillRule fillRule) : matchMap(matchMap), shape(shape), projection(projection), fillRule(fillRule) { }
+
+template <int N>
+bool MSDFSignCorrection::correctRow(const BitmapRef<float, N> &sdf, ScanlineSweep &sweep, Scanline &scanline, int y) const {
+    int w = sdf.width, h = sdf.height;
+    int row = shape.inverseYAxis ? h-y-1 : y;
+    // The match map records whether each texel matched the fill (1), had to be inverted (-1), or is ambiguous (0)
+    char *match = matchMap+w*y;
+    bool ambiguous = false;
+    sweep.scanline(scanline, projection.unprojectY(y+.5));
+    for (int x = 0; x < w; ++x) {
+        bool fill = scanline.filled(projection.unprojectX(x+.5), fillRule);
+        float *msd = sdf(x, row);
+        float sd = median(msd[0], msd[1], msd[2]);
+        if (sd == .5f) {
+            ambiguous = true;
+            *match = 0;
+        } else if ((sd > .5f) != fill) {
+            msd[0] = 1.f-msd[0];
+            msd[1] = 1.f-msd[1];
+            msd[2] = 1.f-msd[2];
+            *match = -1;
+        } else
+            *match = 1;
+        if (N >= 4 && (msd[3] > .5f) != fill)
+            msd[3] = 1.f-msd[3];
+        ++match;
+    }
+    return ambiguous;
+}
+
+template <int N>
+void MSDFSignCorrection::resolveRow(const BitmapRef<float, N> &sdf, int y) const {
+    int w = sdf.width, h = sdf.height;
+    int row = shape.inverseYAxis ? h-y-1 : y;
+    const char *match = matchMap+w*y;
+    for (int x = 0; x < w; ++x) {
+        if (!*match) {
+            int neighborMatch = 0;
+            if (x > 0) neighborMatch += *(match-1);
+            if (x < w-1) neighborMatch += *(match+1);
+            if (y > 0) neighborMatch += *(match-w);
+            if (y < h-1) neighborMatch += *(match+w);
+            if (neighborMatch < 0) {
+                float *msd = sdf(x, row);
+                msd[0] = 1.f-msd[0];
+                msd[1] = 1.f-msd[1];
+                msd[2] = 1.f-msd[2];
+            }
+        }
+        ++match;
+    }
+}
+
+template bool MSDFSignCorrection::correctRow(const BitmapRef<float, 3> &sdf, ScanlineSweep &sweep, Scanline &scanline, int y) const;
+template bool MSDFSignCorrection::correctRow(const BitmapRef<float, 4> &sdf, ScanlineSweep &sweep, Scanline &scanline, int y) const;
+template void MSDFSignCorrection::resolveRow(const BitmapRef<float, 3> &sdf, int y) const;
+template void MSDFSignCorrection::resolveRow(const BitmapRef<float, 4> &sdf, int y) const;
+
+}
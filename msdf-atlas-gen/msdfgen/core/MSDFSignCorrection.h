@@ -0,0 +1,35 @@
+
+#pragma once
+
+#include "Projection.h"
+#include "Shape.h"
+#include "Scanline.h"
+#include "ScanlineSweep.h"
+#include "BitmapRef.hpp"
+
+namespace msdfgen {
+
+/// Corrects the signs of a computed MSDF so that they match the shape's fill. This is a low-level class, you may want to use distanceSignCorrection in rasterization.h instead.
+/// Rows are indexed in the direction of the shape's Y axis (see Shape::inverseYAxis). They may be corrected in any order and by multiple threads,
+/// but the ambiguous texels of a row can only be resolved once both of its neighboring rows have been corrected.
+class MSDFSignCorrection {
+
+public:
+    /// The match map records for each texel whether it matched the fill, and must have as many elements as the MSDF has pixels.
+    MSDFSignCorrection(char *matchMap, const Shape &shape, const Projection &projection, FillRule fillRule);
+    /// Corrects the signs of row y according to its scanline, which is obtained from sweep. Returns true if the row has ambiguous texels, whose median is exactly 0.5.
+    template <int N>
+    bool correctRow(const BitmapRef<float, N> &sdf, ScanlineSweep &sweep, Scanline &scanline, int y) const;
+    /// Inverts the ambiguous texels of row y whose neighbors were mostly inverted, which avoids artifacts when the whole shape is inverted.
+    template <int N>
+    void resolveRow(const BitmapRef<float, N> &sdf, int y) const;
+
+private:
+    char *matchMap;
+    const Shape &shape;
+    Projection projection;
+    FillRule fillRule;
+
+};
+
+}
@@ -67,11 +67,16 @@ void Scanline::preprocess() {
     lastIndex = 0;
     if (!intersections.empty()) {
         qsort(&intersections[0], intersections.size(), sizeof(Intersection), compareIntersections);
-        int totalDirection = 0;
-        for (std::vector<Intersection>::iterator intersection = intersections.begin(); intersection != intersections.end(); ++intersection) {
-            totalDirection += intersection->direction;
-            intersection->direction = totalDirection;
-        }
+        accumulateDirections();
+    }
+}
+
+void Scanline::accumulateDirections() {
+    lastIndex = 0;
+    int totalDirection = 0;
+    for (std::vector<Intersection>::iterator intersection = intersections.begin(); intersection != intersections.end(); ++intersection) {
+        totalDirection += intersection->direction;
+        intersection->direction = totalDirection;
     }
 }
 
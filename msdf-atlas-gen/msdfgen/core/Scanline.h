@@ -18,6 +18,7 @@ bool interpretFillRule(int intersections, FillRule fillRule);
 
 /// Represents a horizontal scanline intersecting a shape.
 class Scanline {
+    friend class ScanlineSweep;
 
 public:
     /// An intersection with the scanline.
@@ -48,6 +49,7 @@ private:
     mutable int lastIndex;
 
     void preprocess();
+    void accumulateDirections();
     int moveTo(double x) const;
 
 };
@@ -0,0 +1,93 @@
+
+#include "ScanlineSweep.h"
+
+#include <cmath>
+#include <algorithm>
+#include "arithmetics.hpp"
+
+namespace msdfgen {
+
+bool ScanlineSweep::compareEdgeStart(const Edge &a, const Edge &b) {
+    return a.yMin < b.yMin;
+}
+
+template <int N>
+static void controlPointExtent(double &yMin, double &yMax, const Point2 (&p)[N]) {
+    yMin = yMax = p[0].y;
+    for (int i = 1; i < N; ++i) {
+        yMin = min(yMin, p[i].y);
+        yMax = max(yMax, p[i].y);
+    }
+}
+
+ScanlineSweep::ScanlineSweep() : nextEdge(0), lastY(0) { }
+
+ScanlineSweep::ScanlineSweep(const Shape &shape) : nextEdge(0), lastY(0) {
+    reset(shape);
+}
+
+void ScanlineSweep::reset(const Shape &shape) {
+    nextEdge = 0;
+    lastY = 0;
+    edges.clear();
+    activeEdges.clear();
+    edges.reserve(shape.edgeCount());
+    for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour) {
+        for (std::vector<EdgeHolder>::const_iterator edgeHolder = contour->edges.begin(); edgeHolder != contour->edges.end(); ++edgeHolder) {
+            Edge edge;
+            edge.segment = *edgeHolder;
+            if (const LinearSegment *linear = dynamic_cast<const LinearSegment *>(edge.segment))
+                controlPointExtent(edge.yMin, edge.yMax, linear->p);
+            else if (const QuadraticSegment *quadratic = dynamic_cast<const QuadraticSegment *>(edge.segment))
+                controlPointExtent(edge.yMin, edge.yMax, quadratic->p);
+            else if (const CubicSegment *cubic = dynamic_cast<const CubicSegment *>(edge.segment))
+                controlPointExtent(edge.yMin, edge.yMax, cubic->p);
+            else {
+                // The extent of other segment types is unknown, so they are always active
+                edge.yMin = -HUGE_VAL;
+                edge.yMax = HUGE_VAL;
+            }
+            edges.push_back(edge);
+        }
+    }
+    std::stable_sort(edges.begin(), edges.end(), compareEdgeStart);
+    activeEdges.reserve(edges.size());
+}
+
+void ScanlineSweep::scanline(Scanline &line, double y) {
+    if (y < lastY || y != y) {
+        nextEdge = 0;
+        activeEdges.clear();
+    }
+    lastY = y;
+    // Retire edges that end below y
+    int activeCount = 0;
+    for (int i = 0; i < (int) activeEdges.size(); ++i)
+        if (edges[activeEdges[i]].yMax >= y)
+            activeEdges[activeCount++] = activeEdges[i];
+    activeEdges.resize(activeCount);
+    // Activate edges that start at or below y
+    for (; nextEdge < (int) edges.size() && edges[nextEdge].yMin <= y; ++nextEdge)
+        if (edges[nextEdge].yMax >= y)
+            activeEdges.push_back(nextEdge);
+
+    // The intersections are kept sorted by insertion, which is cheap since there are only a few of them
+    std::vector<Scanline::Intersection> &intersections = line.intersections;
+    intersections.clear();
+    double x[3];
+    int dy[3];
+    for (std::vector<int>::const_iterator edge = activeEdges.begin(); edge != activeEdges.end(); ++edge) {
+        int n = edges[*edge].segment->scanlineIntersections(x, dy, y);
+        for (int i = 0; i < n; ++i) {
+            Scanline::Intersection intersection = { x[i], dy[i] };
+            intersections.push_back(intersection);
+            int j = (int) intersections.size()-1;
+            for (; j > 0 && intersections[j-1].x > intersection.x; --j)
+                intersections[j] = intersections[j-1];
+            intersections[j] = intersection;
+        }
+    }
+    line.accumulateDirections();
+}
+
+}
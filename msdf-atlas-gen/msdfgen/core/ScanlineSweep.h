@@ -0,0 +1,40 @@
+
+#pragma once
+
+#include <vector>
+#include "Shape.h"
+#include "Scanline.h"
+
+namespace msdfgen {
+
+/// Computes the scanlines of a shape for a sequence of Y coordinates, producing the same intersections as Shape::scanline.
+/// The edges are sorted by their vertical extent once, and only those in an active edge table that span the current Y are intersected,
+/// so that the rows of a bitmap can be rasterized without visiting every edge or allocating memory for each of them.
+/// The table advances incrementally while Y is non-decreasing between calls and is rebuilt otherwise. The shape must not change while in use.
+class ScanlineSweep {
+
+public:
+    ScanlineSweep();
+    explicit ScanlineSweep(const Shape &shape);
+    /// Rebuilds the edge table for a different shape, reusing the allocated memory.
+    void reset(const Shape &shape);
+    /// Outputs the scanline that intersects the shape at y.
+    void scanline(Scanline &line, double y);
+
+private:
+    struct Edge {
+        const EdgeSegment *segment;
+        // Vertical extent of the segment's control points, outside of which it has no scanline intersections
+        double yMin, yMax;
+    };
+
+    std::vector<Edge> edges;
+    std::vector<int> activeEdges;
+    int nextEdge;
+    double lastY;
+
+    static bool compareEdgeStart(const Edge &a, const Edge &b);
+
+};
+
+}
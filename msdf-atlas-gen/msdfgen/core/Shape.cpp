@@ -76,6 +76,161 @@ void Shape::normalize() {
     }
 }
 
+static double controlPolygonLength(const EdgeSegment *edge) {
+    if (const LinearSegment *linear = dynamic_cast<const LinearSegment *>(edge))
+        return (linear->p[1]-linear->p[0]).length();
+    if (const QuadraticSegment *quadratic = dynamic_cast<const QuadraticSegment *>(edge))
+        return (quadratic->p[1]-quadratic->p[0]).length()+(quadratic->p[2]-quadratic->p[1]).length();
+    if (const CubicSegment *cubic = dynamic_cast<const CubicSegment *>(edge))
+        return (cubic->p[1]-cubic->p[0]).length()+(cubic->p[2]-cubic->p[1]).length()+(cubic->p[3]-cubic->p[2]).length();
+    return 0;
+}
+
+/// Moves an end point of the edge without adjusting its inner control point (except the adjacent one of a cubic curve), so that no point of the edge moves farther than the end point
+static void translateEndPoint(EdgeSegment *edge, int end, Point2 to) {
+    if (LinearSegment *linear = dynamic_cast<LinearSegment *>(edge))
+        linear->p[end] = to;
+    else if (QuadraticSegment *quadratic = dynamic_cast<QuadraticSegment *>(edge))
+        quadratic->p[2*end] = to;
+    else if (CubicSegment *cubic = dynamic_cast<CubicSegment *>(edge)) {
+        if (end)
+            cubic->moveEndPoint(to);
+        else
+            cubic->moveStartPoint(to);
+    }
+}
+
+/// Returns true if all points lie within tolerance of the line segment from a to b and follow each other in its direction
+static bool isLinearRun(Point2 a, const std::vector<Point2> &points, Point2 b, double tolerance) {
+    Vector2 dir = b-a;
+    double length = dir.length();
+    if (length == 0)
+        return false;
+    dir /= length;
+    double prevParam = 0;
+    for (std::vector<Point2>::const_iterator point = points.begin(); point != points.end(); ++point) {
+        double param = dotProduct(*point-a, dir);
+        if (param <= prevParam || param >= length || fabs(crossProduct(*point-a, dir)) > tolerance)
+            return false;
+        prevParam = param;
+    }
+    return true;
+}
+
+static bool isLinearJoint(const EdgeHolder &prevEdge, const EdgeHolder &edge, double tolerance) {
+    const LinearSegment *prevLinear = dynamic_cast<const LinearSegment *>(&*prevEdge);
+    const LinearSegment *linear = dynamic_cast<const LinearSegment *>(&*edge);
+    return prevLinear && linear && isLinearRun(prevLinear->p[0], std::vector<Point2>(1, linear->p[0]), linear->p[1], tolerance);
+}
+
+static double cubicToQuadraticError(const CubicSegment *cubic) {
+    const Point2 *p = cubic->p;
+    return MSDFGEN_CUBIC_TO_QUADRATIC_ERROR*(p[3]-3*p[2]+3*p[1]-p[0]).length();
+}
+
+static Vector2 cubicDerivative(const Point2 *p, double t) {
+    return 3*(mix(mix(p[1]-p[0], p[2]-p[1], t), mix(p[2]-p[1], p[3]-p[2], t), t));
+}
+
+void Shape::simplify(double tolerance) {
+    // Each of the three steps may move the outline by a third of the tolerance
+    double stepTolerance = tolerance/3;
+    std::vector<EdgeHolder> simplified;
+    std::vector<Point2> runPoints;
+    std::vector<bool> movedEdges;
+    for (std::vector<Contour>::iterator contour = contours.begin(); contour != contours.end(); ++contour) {
+        // Reduce cubic curves to quadratic curves
+        for (std::vector<EdgeHolder>::iterator edge = contour->edges.begin(); edge != contour->edges.end(); ++edge) {
+            if (const CubicSegment *cubic = dynamic_cast<const CubicSegment *>(&**edge)) {
+                const Point2 *p = cubic->p;
+                if (cubicToQuadraticError(cubic) <= stepTolerance)
+                    *edge = EdgeHolder(p[0], .25*(3*(p[1]+p[2])-p[0]-p[3]), p[3], cubic->color);
+            }
+        }
+
+        // Remove short edges, joining their neighbors at their midpoint, which is at most half the edge's length away from its points.
+        // Edges whose end point has already been moved are kept, so that no point is moved more than once
+        movedEdges.assign(contour->edges.size(), false);
+        for (int i = 0; i < (int) contour->edges.size() && contour->edges.size() > 2;) {
+            EdgeSegment *edge = contour->edges[i];
+            if (!movedEdges[i] && controlPolygonLength(edge) < 2*stepTolerance) {
+                int m = (int) contour->edges.size();
+                Point2 joint = .5*(edge->point(0)+edge->point(1));
+                translateEndPoint(contour->edges[(i+m-1)%m], 1, joint);
+                translateEndPoint(contour->edges[(i+1)%m], 0, joint);
+                movedEdges[(i+m-1)%m] = true;
+                movedEdges[(i+1)%m] = true;
+                contour->edges.erase(contour->edges.begin()+i);
+                movedEdges.erase(movedEdges.begin()+i);
+            } else
+                ++i;
+        }
+
+        // Merge runs of collinear line segments, starting after a joint that cannot be merged
+        int m = (int) contour->edges.size();
+        int start = 0;
+        while (start < m && isLinearJoint(contour->edges[(start+m-1)%m], contour->edges[start], stepTolerance))
+            ++start;
+        if (m <= 2 || start == m)
+            continue;
+        simplified.clear();
+        simplified.reserve(m);
+        for (int i = 0; i < m; ++i) {
+            EdgeHolder &edge = contour->edges[(start+i)%m];
+            LinearSegment *linear = dynamic_cast<LinearSegment *>(&*edge);
+            LinearSegment *prevLinear = simplified.empty() ? NULL : dynamic_cast<LinearSegment *>(&*simplified.back());
+            if (linear && prevLinear) {
+                runPoints.push_back(linear->p[0]);
+                if (isLinearRun(prevLinear->p[0], runPoints, linear->p[1], stepTolerance)) {
+                    prevLinear->p[1] = linear->p[1];
+                    continue;
+                }
+            }
+            runPoints.clear();
+            simplified.push_back(EdgeHolder());
+            EdgeHolder::swap(simplified.back(), edge);
+        }
+        runPoints.clear();
+        contour->edges.swap(simplified);
+    }
+}
+
+void Shape::convertCubicsToQuadratics(double tolerance) {
+    std::vector<EdgeHolder> converted;
+    for (std::vector<Contour>::iterator contour = contours.begin(); contour != contours.end(); ++contour) {
+        bool hasCubics = false;
+        for (std::vector<EdgeHolder>::const_iterator edge = contour->edges.begin(); edge != contour->edges.end() && !hasCubics; ++edge)
+            hasCubics = dynamic_cast<const CubicSegment *>(&**edge) != NULL;
+        if (!hasCubics)
+            continue;
+        converted.clear();
+        converted.reserve(contour->edges.size());
+        for (std::vector<EdgeHolder>::iterator edge = contour->edges.begin(); edge != contour->edges.end(); ++edge) {
+            if (const CubicSegment *cubic = dynamic_cast<const CubicSegment *>(&**edge)) {
+                // The error of the degree reduction of a part of the curve decreases with the cube of its parameter span
+                double error = cubicToQuadraticError(cubic);
+                int parts = error > tolerance ? (int) ceil(min(pow(error/tolerance, 1./3.), (double) MSDFGEN_MAX_CUBIC_TO_QUADRATIC_PARTS)) : 1;
+                const Point2 *p = cubic->p;
+                double span = 1./parts;
+                Point2 start = p[0];
+                Vector2 startDerivative = cubicDerivative(p, 0);
+                for (int i = 1; i <= parts; ++i) {
+                    double t = i*span;
+                    Point2 end = i == parts ? p[3] : cubic->point(t);
+                    Vector2 endDerivative = cubicDerivative(p, t);
+                    converted.push_back(EdgeHolder(start, .5*(start+end)+.25*span*(startDerivative-endDerivative), end, cubic->color));
+                    start = end;
+                    startDerivative = endDerivative;
+                }
+            } else {
+                converted.push_back(EdgeHolder());
+                EdgeHolder::swap(converted.back(), *edge);
+            }
+        }
+        contour->edges.swap(converted);
+    }
+}
+
 void Shape::bound(double &l, double &b, double &r, double &t) const {
     for (std::vector<Contour>::const_iterator contour = contours.begin(); contour != contours.end(); ++contour)
         contour->bound(l, b, r, t);
@@ -11,6 +11,10 @@ namespace msdfgen {
 #define MSDFGEN_CORNER_DOT_EPSILON .000001
 // The proportional amount by which a curve's control point will be adjusted to eliminate convergent corners.
 #define MSDFGEN_DECONVERGENCE_FACTOR .000001
+// The maximum distance between a cubic curve and its degree-reduced quadratic curve relative to the length of the cubic's third difference vector (sqrt(3)/36).
+#define MSDFGEN_CUBIC_TO_QUADRATIC_ERROR .0481125224324688
+// The maximum number of quadratic curves a single cubic curve may be converted into.
+#define MSDFGEN_MAX_CUBIC_TO_QUADRATIC_PARTS 64
 
 /// Vector shape representation.
 class Shape {
@@ -35,6 +39,13 @@ public:
     Contour & addContour();
     /// Normalizes the shape geometry for distance field generation.
     void normalize();
+    /// Reduces the number of edges while keeping the outline within tolerance (in shape units) of the original.
+    /// Replaces cubic curves by quadratic curves, removes short edges, and merges consecutive collinear line segments, each step within a third of the tolerance.
+    /// Should be followed by normalize and done before edge coloring.
+    void simplify(double tolerance);
+    /// Replaces each cubic curve by the minimal number of quadratic curves of the same color that deviate from it by at most tolerance (in shape units).
+    /// Preserves the end points of edges, so it may be done after edge coloring.
+    void convertCubicsToQuadratics(double tolerance);
     /// Performs basic checks to determine if the object represents a valid shape.
     bool validate() const;
     /// Adjusts the bounding box to fit the shape.
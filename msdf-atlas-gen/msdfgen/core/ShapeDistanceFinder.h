@@ -5,6 +5,7 @@
 #include "Vector2.h"
 #include "edge-selectors.h"
 #include "contour-combiners.h"
+#include "FlatShape.h"
 
 namespace msdfgen {
 
@@ -30,6 +31,26 @@ private:
 
 };
 
+/// Produces the same result as ShapeDistanceFinder, visiting the edges of a FlatShape made from the shape instead of its EdgeSegment objects.
+/// If Real is float, the edge distances are computed in single precision.
+template <class ContourCombiner, typename Real = double>
+class FlatShapeDistanceFinder {
+
+public:
+    typedef typename ContourCombiner::DistanceType DistanceType;
+
+    // Passed shape object must persist until the distance finder is destroyed!
+    explicit FlatShapeDistanceFinder(const Shape &shape);
+    /// Finds the distance from origin. Not thread-safe! Is fastest when subsequent queries are close together.
+    DistanceType distance(const Point2 &origin);
+
+private:
+    FlatShape flatShape;
+    ContourCombiner contourCombiner;
+    std::vector<typename ContourCombiner::EdgeSelectorType::EdgeCache> shapeEdgeCache;
+
+};
+
 typedef ShapeDistanceFinder<SimpleContourCombiner<TrueDistanceSelector> > SimpleTrueShapeDistanceFinder;
 
 }
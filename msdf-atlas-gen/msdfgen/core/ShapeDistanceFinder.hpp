@@ -53,4 +53,22 @@ typename ShapeDistanceFinder<ContourCombiner>::DistanceType ShapeDistanceFinder<
     return contourCombiner.distance();
 }
 
+template <class ContourCombiner, typename Real>
+FlatShapeDistanceFinder<ContourCombiner, Real>::FlatShapeDistanceFinder(const Shape &shape) : flatShape(shape), contourCombiner(shape), shapeEdgeCache(flatShape.edgeCount()) { }
+
+template <class ContourCombiner, typename Real>
+typename FlatShapeDistanceFinder<ContourCombiner, Real>::DistanceType FlatShapeDistanceFinder<ContourCombiner, Real>::distance(const Point2 &origin) {
+    contourCombiner.reset(origin);
+    int edgeCount = flatShape.edgeCount();
+    for (int i = 0; i < edgeCount; ++i) {
+        typename ContourCombiner::EdgeSelectorType &edgeSelector = contourCombiner.edgeSelector(flatShape.contourIndex(i));
+        if (edgeSelector.needsEdgeDistance(shapeEdgeCache[i], flatShape, i)) {
+            double param;
+            SignedDistance distance = flatShape.signedDistance<Real>(i, origin, param);
+            edgeSelector.addEdgeDistance(shapeEdgeCache[i], flatShape, i, distance, param);
+        }
+    }
+    return contourCombiner.distance();
+}
+
 }
@@ -0,0 +1,170 @@
+
+#include "ThreadPool.h"
+
+#include <cstdlib>
+#ifdef MSDFGEN_USE_OPENMP
+#include <omp.h>
+#elif defined(MSDFGEN_USE_CPP11)
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#endif
+
+namespace msdfgen {
+
+ThreadPool::Chunks::Chunks(int count) : nextChunk(0), count(count) { }
+
+bool ThreadPool::Chunks::next(int &chunk) {
+#if defined(MSDFGEN_USE_OPENMP) && !defined(MSDFGEN_USE_CPP11)
+    #pragma omp atomic capture
+    chunk = nextChunk++;
+#else
+    chunk = nextChunk++;
+#endif
+    return chunk < count;
+}
+
+#if defined(MSDFGEN_USE_CPP11) && !defined(MSDFGEN_USE_OPENMP)
+
+struct ThreadPool::Workers {
+    /// A task submitted to the pool, which may still be joined by slots more worker threads.
+    struct Assignment {
+        Task *task;
+        Chunks *chunks;
+        int slots;
+        int active;
+    };
+
+    std::vector<std::thread> threads;
+    std::deque<Assignment *> queue;
+    std::mutex mutex;
+    std::condition_variable assignmentAvailable, assignmentFinished;
+    bool stopping;
+
+    Workers() : stopping(false) { }
+
+    void loop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            while (!stopping && queue.empty())
+                assignmentAvailable.wait(lock);
+            if (stopping)
+                return;
+            Assignment *assignment = queue.front();
+            if (!--assignment->slots)
+                queue.pop_front();
+            ++assignment->active;
+            lock.unlock();
+            assignment->task->work(*assignment->chunks);
+            lock.lock();
+            if (!--assignment->active)
+                assignmentFinished.notify_all();
+        }
+    }
+};
+
+ThreadPool::ThreadPool(int workerCount) : workers(new Workers), workerCount(workerCount) {
+    workers->threads.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i)
+        workers->threads.push_back(std::thread(&Workers::loop, workers));
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(workers->mutex);
+        workers->stopping = true;
+    }
+    workers->assignmentAvailable.notify_all();
+    for (std::vector<std::thread>::iterator thread = workers->threads.begin(); thread != workers->threads.end(); ++thread)
+        thread->join();
+    delete workers;
+}
+
+ThreadPool & ThreadPool::shared() {
+    // The calling thread is one of the threads working on each task
+    static ThreadPool pool(std::max((int) std::thread::hardware_concurrency(), 1)-1);
+    return pool;
+}
+
+int ThreadPool::threadCount() const {
+    return workerCount+1;
+}
+
+void ThreadPool::process(Task &task, int chunkCount, int threadCount) {
+    if (threadCount <= 0 || threadCount > workerCount+1)
+        threadCount = workerCount+1;
+    if (threadCount > chunkCount)
+        threadCount = chunkCount;
+    Chunks chunks(chunkCount);
+    if (threadCount <= 1) {
+        task.work(chunks);
+        return;
+    }
+    Workers::Assignment assignment = { &task, &chunks, threadCount-1, 0 };
+    {
+        std::lock_guard<std::mutex> lock(workers->mutex);
+        workers->queue.push_back(&assignment);
+    }
+    for (int i = 1; i < threadCount; ++i)
+        workers->assignmentAvailable.notify_one();
+    task.work(chunks);
+    std::unique_lock<std::mutex> lock(workers->mutex);
+    // All chunks have been handed out, so there is no point in further threads joining
+    std::deque<Workers::Assignment *>::iterator queued = std::find(workers->queue.begin(), workers->queue.end(), &assignment);
+    if (queued != workers->queue.end())
+        workers->queue.erase(queued);
+    while (assignment.active)
+        workers->assignmentFinished.wait(lock);
+}
+
+#else
+
+struct ThreadPool::Workers { };
+
+ThreadPool::ThreadPool(int workerCount) : workers(NULL), workerCount(workerCount) { }
+
+ThreadPool::~ThreadPool() { }
+
+ThreadPool & ThreadPool::shared() {
+#ifdef MSDFGEN_USE_OPENMP
+    static ThreadPool pool(omp_get_max_threads()-1);
+#else
+    static ThreadPool pool(0);
+#endif
+    return pool;
+}
+
+int ThreadPool::threadCount() const {
+    return workerCount+1;
+}
+
+void ThreadPool::process(Task &task, int chunkCount, int threadCount) {
+    if (threadCount <= 0 || threadCount > workerCount+1)
+        threadCount = workerCount+1;
+    if (threadCount > chunkCount)
+        threadCount = chunkCount;
+    Chunks chunks(chunkCount);
+#ifdef MSDFGEN_USE_OPENMP
+    if (threadCount > 1) {
+        #pragma omp parallel num_threads(threadCount)
+        task.work(chunks);
+        return;
+    }
+#endif
+    task.work(chunks);
+}
+
+#endif
+
+void ThreadPool::run(Task &task, int chunkCount, int threadCount) {
+    if (threadCount == 1 || chunkCount <= 1) {
+        Chunks chunks(chunkCount);
+        task.work(chunks);
+    } else
+        shared().process(task, chunkCount, threadCount);
+}
+
+}
@@ -0,0 +1,67 @@
+
+#pragma once
+
+#ifdef MSDFGEN_USE_CPP11
+#include <atomic>
+#endif
+
+// Number of rows of a bitmap processed as one chunk by the parallelized generator functions.
+#define MSDFGEN_PARALLEL_BAND_HEIGHT 16
+
+namespace msdfgen {
+
+/// A pool of worker threads used by the generator functions to process a single bitmap in bands of rows.
+/// Several threads may submit tasks at the same time. As the submitting thread always participates in its task,
+/// tasks complete even if all of the pool's threads are busy. Without C++11, tasks are processed by the calling thread alone,
+/// and if MSDFGEN_USE_OPENMP is defined, they are processed by OpenMP threads instead of the pool's.
+class ThreadPool {
+
+public:
+    /// Hands out the indices of a task's chunks to the threads working on it.
+    class Chunks {
+    public:
+        explicit Chunks(int count);
+        /// Retrieves the index of the next unprocessed chunk. Returns false if there are none left.
+        bool next(int &chunk);
+    private:
+#ifdef MSDFGEN_USE_CPP11
+        std::atomic<int> nextChunk;
+#else
+        int nextChunk;
+#endif
+        int count;
+    };
+
+    /// A task split into chunks which may be processed in parallel.
+    class Task {
+    public:
+        virtual ~Task() { }
+        /// Called once on each thread working on the task. Should set up any per-thread state, then retrieve and process chunks until none are left.
+        virtual void work(Chunks &chunks) = 0;
+    };
+
+    /// Processes the task on the calling thread if threadCount is 1, or using the shared pool otherwise (0 = one thread per CPU core).
+    static void run(Task &task, int chunkCount, int threadCount);
+    /// Returns the pool used by run, which is started on first use.
+    static ThreadPool & shared();
+
+    /// Starts the specified number of worker threads.
+    explicit ThreadPool(int workerCount);
+    ~ThreadPool();
+    /// Returns the maximum number of threads that may work on a single task, including the submitting thread.
+    int threadCount() const;
+    /// Processes the task using up to threadCount threads (0 = all) including the calling thread, and returns once all chunks have been processed.
+    void process(Task &task, int chunkCount, int threadCount);
+
+private:
+    struct Workers;
+
+    Workers *workers;
+    int workerCount;
+
+    ThreadPool(const ThreadPool &);
+    ThreadPool & operator=(const ThreadPool &);
+
+};
+
+}
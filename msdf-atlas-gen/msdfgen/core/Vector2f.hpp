@@ -0,0 +1,67 @@
+
+#pragma once
+
+#include <cmath>
+#include "Vector2.h"
+
+namespace msdfgen {
+
+/// A 2-dimensional euclidean vector with single precision, used by the single-precision distance kernels.
+/// Provides the subset of Vector2's interface needed by edge-segment-kernels.hpp, implemented inline.
+struct Vector2f {
+    float x, y;
+
+    inline Vector2f(float val = 0) : x(val), y(val) { }
+    inline Vector2f(float x, float y) : x(x), y(y) { }
+    inline explicit Vector2f(const Vector2 &vector) : x(float(vector.x)), y(float(vector.y)) { }
+
+    /// Returns the vector's length.
+    inline float length() const {
+        return std::sqrt(x*x+y*y);
+    }
+    /// Returns the normalized vector - one that has the same direction but unit length.
+    inline Vector2f normalize(bool allowZero = false) const {
+        float len = length();
+        if (len == 0)
+            return Vector2f(0, (float) !allowZero);
+        return Vector2f(x/len, y/len);
+    }
+    /// Returns a vector with unit length that is orthogonal to this one.
+    inline Vector2f getOrthonormal(bool polarity = true, bool allowZero = false) const {
+        float len = length();
+        if (len == 0)
+            return polarity ? Vector2f(0, (float) !allowZero) : Vector2f(0, (float) -!allowZero);
+        return polarity ? Vector2f(-y/len, x/len) : Vector2f(y/len, -x/len);
+    }
+
+    inline bool operator!() const {
+        return !x && !y;
+    }
+    inline Vector2f operator-() const {
+        return Vector2f(-x, -y);
+    }
+    inline Vector2f operator+(const Vector2f &other) const {
+        return Vector2f(x+other.x, y+other.y);
+    }
+    inline Vector2f operator-(const Vector2f &other) const {
+        return Vector2f(x-other.x, y-other.y);
+    }
+    inline Vector2f operator*(float value) const {
+        return Vector2f(x*value, y*value);
+    }
+
+    /// Dot product of two vectors.
+    friend inline float dotProduct(const Vector2f &a, const Vector2f &b) {
+        return a.x*b.x+a.y*b.y;
+    }
+    /// A special version of the cross product for 2D vectors (returns scalar value).
+    friend inline float crossProduct(const Vector2f &a, const Vector2f &b) {
+        return a.x*b.y-a.y*b.x;
+    }
+    friend inline Vector2f operator*(float value, const Vector2f &vector) {
+        return Vector2f(value*vector.x, value*vector.y);
+    }
+
+};
+
+}
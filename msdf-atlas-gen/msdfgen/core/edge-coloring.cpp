@@ -244,15 +244,72 @@ static double edgeToEdgeDistance(const EdgeSegment &a, const EdgeSegment &b, int
     return minDistance;
 }
 
-static double splineToSplineDistance(EdgeSegment * const *edgeSegments, int aStart, int aEnd, int bStart, int bEnd, int precision) {
-    double minDistance = DBL_MAX;
-    for (int ai = aStart; ai < aEnd; ++ai)
-        for (int bi = bStart; bi < bEnd && minDistance; ++bi) {
-            double d = edgeToEdgeDistance(*edgeSegments[ai], *edgeSegments[bi], precision);
+static double boundsDistance(const Shape::Bounds &a, const Shape::Bounds &b) {
+    double dx = max(max(a.l-b.r, b.l-a.r), 0.);
+    double dy = max(max(a.b-b.t, b.b-a.t), 0.);
+    return sqrt(dx*dx+dy*dy);
+}
+
+struct EdgeColoringSegmentPair {
+    double boundsDistance;
+    int a, b;
+};
+
+static int cmpSegmentPairs(const void *a, const void *b) {
+    return sign(reinterpret_cast<const EdgeColoringSegmentPair *>(a)->boundsDistance-reinterpret_cast<const EdgeColoringSegmentPair *>(b)->boundsDistance);
+}
+
+/// Spatial index of the segments of each spline - the distance between bounding boxes bounds the distance between the segments from below
+class EdgeColoringSplineIndex {
+
+public:
+    EdgeColoringSplineIndex(EdgeSegment * const *edgeSegments, const int *splineStarts, int splineCount) : edgeSegments(edgeSegments), splineStarts(splineStarts), segmentBounds(splineStarts[splineCount]), splineBounds(splineCount) {
+        for (int i = 0; i < splineCount; ++i) {
+            Shape::Bounds splineBox = { +DBL_MAX, +DBL_MAX, -DBL_MAX, -DBL_MAX };
+            for (int j = splineStarts[i]; j < splineStarts[i+1]; ++j) {
+                Shape::Bounds &box = segmentBounds[j];
+                box.l = +DBL_MAX, box.b = +DBL_MAX, box.r = -DBL_MAX, box.t = -DBL_MAX;
+                edgeSegments[j]->bound(box.l, box.b, box.r, box.t);
+                splineBox.l = min(splineBox.l, box.l), splineBox.b = min(splineBox.b, box.b);
+                splineBox.r = max(splineBox.r, box.r), splineBox.t = max(splineBox.t, box.t);
+            }
+            splineBounds[i] = splineBox;
+        }
+    }
+
+    /// Same as the minimum edgeToEdgeDistance over all pairs of segments of the two splines, but skips the pairs whose bounding boxes are farther apart than the closest pair found so far
+    double splineToSplineDistance(int a, int b, int precision) {
+        // The first term of each edgeToEdgeDistance is the distance between the edges' start points, so their minimum is an upper bound of the result
+        double minDistance = DBL_MAX;
+        for (int ai = splineStarts[a]; ai < splineStarts[a+1]; ++ai)
+            for (int bi = splineStarts[b]; bi < splineStarts[b+1]; ++bi)
+                minDistance = min(minDistance, (edgeSegments[bi]->point(0)-edgeSegments[ai]->point(0)).length());
+        if (boundsDistance(splineBounds[a], splineBounds[b]) >= minDistance)
+            return minDistance;
+        candidates.clear();
+        for (int ai = splineStarts[a]; ai < splineStarts[a+1]; ++ai)
+            for (int bi = splineStarts[b]; bi < splineStarts[b+1]; ++bi) {
+                EdgeColoringSegmentPair candidate = { boundsDistance(segmentBounds[ai], segmentBounds[bi]), ai, bi };
+                if (candidate.boundsDistance < minDistance)
+                    candidates.push_back(candidate);
+            }
+        if (candidates.size() > 1)
+            qsort(&candidates[0], candidates.size(), sizeof(EdgeColoringSegmentPair), &cmpSegmentPairs);
+        for (std::vector<EdgeColoringSegmentPair>::const_iterator candidate = candidates.begin(); candidate != candidates.end() && candidate->boundsDistance < minDistance; ++candidate) {
+            double d = edgeToEdgeDistance(*edgeSegments[candidate->a], *edgeSegments[candidate->b], precision);
             minDistance = min(minDistance, d);
         }
-    return minDistance;
-}
+        return minDistance;
+    }
+
+private:
+    EdgeSegment * const *edgeSegments;
+    const int *splineStarts;
+    std::vector<Shape::Bounds> segmentBounds;
+    std::vector<Shape::Bounds> splineBounds;
+    std::vector<EdgeColoringSegmentPair> candidates;
+
+};
 
 static void colorSecondDegreeGraph(int *coloring, const int * const *edgeMatrix, int vertexCount, unsigned long long seed) {
     for (int i = 0; i < vertexCount; ++i) {
@@ -450,10 +507,11 @@ void edgeColoringByDistance(Shape &shape, double angleThreshold, unsigned long l
         distanceMatrix[i] = &distanceMatrixStorage[i*splineCount];
     const double *distanceMatrixBase = &distanceMatrixStorage[0];
 
+    EdgeColoringSplineIndex splineIndex(&edgeSegments[0], &splineStarts[0], splineCount);
     for (int i = 0; i < splineCount; ++i) {
         distanceMatrix[i][i] = -1;
         for (int j = i+1; j < splineCount; ++j) {
-            double dist = splineToSplineDistance(&edgeSegments[0], splineStarts[i], splineStarts[i+1], splineStarts[j], splineStarts[j+1], EDGE_DISTANCE_PRECISION);
+            double dist = splineIndex.splineToSplineDistance(i, j, EDGE_DISTANCE_PRECISION);
             distanceMatrix[i][j] = dist;
             distanceMatrix[j][i] = dist;
         }
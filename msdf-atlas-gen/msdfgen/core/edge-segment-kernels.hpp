@@ -0,0 +1,213 @@
+
+#pragma once
+
+#include "arithmetics.hpp"
+#include "Vector2.h"
+#include "Vector2f.hpp"
+#include "SignedDistance.h"
+#include "equation-solver.h"
+#include "edge-segments.h"
+
+// Inline implementations of the edge segment operations needed by distance queries, taking the control points directly.
+// Shared by the EdgeSegment classes and FlatShape so that both produce bit-identical results.
+// The kernels are templated on the vector type, Vector2 for double and Vector2f for single precision arithmetic.
+// The resulting distances and parameters are returned in double precision in either case.
+
+namespace msdfgen {
+
+/// The scalar type of a vector type the kernels may be instantiated with.
+template <class V>
+struct KernelScalar;
+
+template <>
+struct KernelScalar<Vector2> {
+    typedef double Type;
+};
+
+template <>
+struct KernelScalar<Vector2f> {
+    typedef float Type;
+};
+
+template <class V>
+inline V linearDirection(const V *p) {
+    return p[1]-p[0];
+}
+
+template <class V>
+inline V quadraticDirection(const V *p, typename KernelScalar<V>::Type param) {
+    V tangent = mix(p[1]-p[0], p[2]-p[1], param);
+    if (!tangent)
+        return p[2]-p[0];
+    return tangent;
+}
+
+template <class V>
+inline V cubicDirection(const V *p, typename KernelScalar<V>::Type param) {
+    V tangent = mix(mix(p[1]-p[0], p[2]-p[1], param), mix(p[2]-p[1], p[3]-p[2], param), param);
+    if (!tangent) {
+        if (param == 0) return p[2]-p[0];
+        if (param == 1) return p[3]-p[1];
+    }
+    return tangent;
+}
+
+template <class V>
+inline SignedDistance linearSignedDistance(const V *p, V origin, double &param) {
+    typedef typename KernelScalar<V>::Type real;
+    V aq = origin-p[0];
+    V ab = p[1]-p[0];
+    param = dotProduct(aq, ab)/dotProduct(ab, ab);
+    V eq = p[param > .5]-origin;
+    real endpointDistance = eq.length();
+    if (param > 0 && param < 1) {
+        real orthoDistance = dotProduct(ab.getOrthonormal(false), aq);
+        if (fabs(orthoDistance) < endpointDistance)
+            return SignedDistance(orthoDistance, 0);
+    }
+    return SignedDistance(nonZeroSign(crossProduct(aq, ab))*endpointDistance, fabs(dotProduct(ab.normalize(), eq.normalize())));
+}
+
+template <class V>
+inline SignedDistance quadraticSignedDistance(const V *p, V origin, double &param) {
+    typedef typename KernelScalar<V>::Type real;
+    V qa = p[0]-origin;
+    V ab = p[1]-p[0];
+    V br = p[2]-p[1]-ab;
+    real a = dotProduct(br, br);
+    real b = 3*dotProduct(ab, br);
+    real c = 2*dotProduct(ab, ab)+dotProduct(qa, br);
+    real d = dotProduct(qa, ab);
+    real t[3];
+    int solutions = solveCubic(t, a, b, c, d);
+
+    V epDir = quadraticDirection(p, 0);
+    real minDistance = nonZeroSign(crossProduct(epDir, qa))*qa.length(); // distance from A
+    param = -dotProduct(qa, epDir)/dotProduct(epDir, epDir);
+    {
+        epDir = quadraticDirection(p, 1);
+        real distance = (p[2]-origin).length(); // distance from B
+        if (distance < fabs(minDistance)) {
+            minDistance = nonZeroSign(crossProduct(epDir, p[2]-origin))*distance;
+            param = dotProduct(origin-p[1], epDir)/dotProduct(epDir, epDir);
+        }
+    }
+    for (int i = 0; i < solutions; ++i) {
+        if (t[i] > 0 && t[i] < 1) {
+            V qe = qa+2*t[i]*ab+t[i]*t[i]*br;
+            real distance = qe.length();
+            if (distance <= fabs(minDistance)) {
+                minDistance = nonZeroSign(crossProduct(ab+t[i]*br, qe))*distance;
+                param = t[i];
+            }
+        }
+    }
+
+    if (param >= 0 && param <= 1)
+        return SignedDistance(minDistance, 0);
+    if (param < .5)
+        return SignedDistance(minDistance, fabs(dotProduct(quadraticDirection(p, 0).normalize(), qa.normalize())));
+    else
+        return SignedDistance(minDistance, fabs(dotProduct(quadraticDirection(p, 1).normalize(), (p[2]-origin).normalize())));
+}
+
+/// Quantities of a cubic segment needed by every distance query, which only depend on its control points.
+template <class V>
+struct CubicCoefficients {
+    /// Polynomial coefficients, the curve being p[0]+3*t*ab+3*t*t*br+t*t*t*as.
+    V ab, br, as;
+    /// Directions at the endpoints, same as cubicDirection(p, 0) and cubicDirection(p, 1).
+    V aDir, bDir;
+    /// Number of intervals between the starting points of the iterative search.
+    int searchStarts;
+};
+
+/// Returns the number of intervals for the iterative closest point search based on the total turning angle of the control polygon,
+/// which bounds that of the curve, so that nearly straight segments are searched from fewer points and loops and cusps from more.
+template <class V>
+inline int cubicSearchStarts(const V *p) {
+    double turning = 0;
+    V prevLeg;
+    for (int i = 0; i < 3; ++i) {
+        V leg = p[i+1]-p[i];
+        if (!leg)
+            continue;
+        if (!!prevLeg)
+            turning += atan2(fabs((double) crossProduct(prevLeg, leg)), (double) dotProduct(prevLeg, leg));
+        prevLeg = leg;
+    }
+    int starts = (int) ceil(turning*(MSDFGEN_CUBIC_SEARCH_STARTS/1.5707963267948966)-1e-9);
+    return clamp(starts, MSDFGEN_CUBIC_SEARCH_MIN_STARTS, MSDFGEN_CUBIC_SEARCH_MAX_STARTS);
+}
+
+template <class V>
+inline void computeCubicCoefficients(CubicCoefficients<V> &c, const V *p) {
+    c.ab = p[1]-p[0];
+    c.br = p[2]-p[1]-c.ab;
+    c.as = (p[3]-p[2])-(p[2]-p[1])-c.br;
+    c.aDir = cubicDirection(p, 0);
+    c.bDir = cubicDirection(p, 1);
+    c.searchStarts = cubicSearchStarts(p);
+}
+
+template <class V>
+inline SignedDistance cubicSignedDistance(const V *p, const CubicCoefficients<V> &c, V origin, double &param) {
+    typedef typename KernelScalar<V>::Type real;
+    V qa = p[0]-origin;
+    V qb = p[3]-origin;
+    const V &ab = c.ab, &br = c.br, &as = c.as;
+
+    V epDir = c.aDir;
+    real minDistance = nonZeroSign(crossProduct(epDir, qa))*qa.length(); // distance from A
+    param = -dotProduct(qa, epDir)/dotProduct(epDir, epDir);
+    bool nearB = false;
+    {
+        epDir = c.bDir;
+        real distance = qb.length(); // distance from B
+        if (distance < fabs(minDistance)) {
+            minDistance = nonZeroSign(crossProduct(epDir, qb))*distance;
+            param = dotProduct(epDir-qb, epDir)/dotProduct(epDir, epDir);
+            nearB = true;
+        }
+    }
+    // If all control points lie beyond the nearest endpoint as seen from origin, so does the convex hull containing the curve,
+    // and no interior point can be closer than the endpoint, making the search futile
+    bool hullBeyond = nearB ?
+        dotProduct(p[0]-p[3], qb) >= 0 && dotProduct(p[1]-p[3], qb) >= 0 && dotProduct(p[2]-p[3], qb) >= 0 :
+        dotProduct(p[1]-p[0], qa) >= 0 && dotProduct(p[2]-p[0], qa) >= 0 && dotProduct(p[3]-p[0], qa) >= 0;
+    // Iterative minimum distance search
+    for (int i = 0; !hullBeyond && i <= c.searchStarts; ++i) {
+        real t = (real) i/c.searchStarts;
+        V qe = qa+3*t*ab+3*t*t*br+t*t*t*as;
+        for (int step = 0; step < MSDFGEN_CUBIC_SEARCH_STEPS; ++step) {
+            // Improve t
+            V d1 = 3*ab+6*t*br+3*t*t*as;
+            V d2 = 6*br+6*t*as;
+            t -= dotProduct(qe, d1)/(dotProduct(d1, d1)+dotProduct(qe, d2));
+            if (t <= 0 || t >= 1)
+                break;
+            qe = qa+3*t*ab+3*t*t*br+t*t*t*as;
+            real distance = qe.length();
+            if (distance < fabs(minDistance)) {
+                minDistance = nonZeroSign(crossProduct(d1, qe))*distance;
+                param = t;
+            }
+        }
+    }
+
+    if (param >= 0 && param <= 1)
+        return SignedDistance(minDistance, 0);
+    if (param < .5)
+        return SignedDistance(minDistance, fabs(dotProduct(c.aDir.normalize(), qa.normalize())));
+    else
+        return SignedDistance(minDistance, fabs(dotProduct(c.bDir.normalize(), qb.normalize())));
+}
+
+template <class V>
+inline SignedDistance cubicSignedDistance(const V *p, V origin, double &param) {
+    CubicCoefficients<V> c;
+    computeCubicCoefficients(c, p);
+    return cubicSignedDistance(p, c, origin, param);
+}
+
+}
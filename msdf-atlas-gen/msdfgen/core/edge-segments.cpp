@@ -3,6 +3,7 @@
 
 #include "arithmetics.hpp"
 #include "equation-solver.h"
+#include "edge-segment-kernels.hpp"
 
 namespace msdfgen {
 
@@ -82,23 +83,15 @@ Point2 CubicSegment::point(double param) const {
 }
 
 Vector2 LinearSegment::direction(double param) const {
-    return p[1]-p[0];
+    return linearDirection(p);
 }
 
 Vector2 QuadraticSegment::direction(double param) const {
-    Vector2 tangent = mix(p[1]-p[0], p[2]-p[1], param);
-    if (!tangent)
-        return p[2]-p[0];
-    return tangent;
+    return quadraticDirection(p, param);
 }
 
 Vector2 CubicSegment::direction(double param) const {
-    Vector2 tangent = mix(mix(p[1]-p[0], p[2]-p[1], param), mix(p[2]-p[1], p[3]-p[2], param), param);
-    if (!tangent) {
-        if (param == 0) return p[2]-p[0];
-        if (param == 1) return p[3]-p[1];
-    }
-    return tangent;
+    return cubicDirection(p, param);
 }
 
 Vector2 LinearSegment::directionChange(double param) const {
@@ -134,103 +127,15 @@ double QuadraticSegment::length() const {
 }
 
 SignedDistance LinearSegment::signedDistance(Point2 origin, double &param) const {
-    Vector2 aq = origin-p[0];
-    Vector2 ab = p[1]-p[0];
-    param = dotProduct(aq, ab)/dotProduct(ab, ab);
-    Vector2 eq = p[param > .5]-origin;
-    double endpointDistance = eq.length();
-    if (param > 0 && param < 1) {
-        double orthoDistance = dotProduct(ab.getOrthonormal(false), aq);
-        if (fabs(orthoDistance) < endpointDistance)
-            return SignedDistance(orthoDistance, 0);
-    }
-    return SignedDistance(nonZeroSign(crossProduct(aq, ab))*endpointDistance, fabs(dotProduct(ab.normalize(), eq.normalize())));
+    return linearSignedDistance(p, origin, param);
 }
 
 SignedDistance QuadraticSegment::signedDistance(Point2 origin, double &param) const {
-    Vector2 qa = p[0]-origin;
-    Vector2 ab = p[1]-p[0];
-    Vector2 br = p[2]-p[1]-ab;
-    double a = dotProduct(br, br);
-    double b = 3*dotProduct(ab, br);
-    double c = 2*dotProduct(ab, ab)+dotProduct(qa, br);
-    double d = dotProduct(qa, ab);
-    double t[3];
-    int solutions = solveCubic(t, a, b, c, d);
-
-    Vector2 epDir = direction(0);
-    double minDistance = nonZeroSign(crossProduct(epDir, qa))*qa.length(); // distance from A
-    param = -dotProduct(qa, epDir)/dotProduct(epDir, epDir);
-    {
-        epDir = direction(1);
-        double distance = (p[2]-origin).length(); // distance from B
-        if (distance < fabs(minDistance)) {
-            minDistance = nonZeroSign(crossProduct(epDir, p[2]-origin))*distance;
-            param = dotProduct(origin-p[1], epDir)/dotProduct(epDir, epDir);
-        }
-    }
-    for (int i = 0; i < solutions; ++i) {
-        if (t[i] > 0 && t[i] < 1) {
-            Point2 qe = qa+2*t[i]*ab+t[i]*t[i]*br;
-            double distance = qe.length();
-            if (distance <= fabs(minDistance)) {
-                minDistance = nonZeroSign(crossProduct(ab+t[i]*br, qe))*distance;
-                param = t[i];
-            }
-        }
-    }
-
-    if (param >= 0 && param <= 1)
-        return SignedDistance(minDistance, 0);
-    if (param < .5)
-        return SignedDistance(minDistance, fabs(dotProduct(direction(0).normalize(), qa.normalize())));
-    else
-        return SignedDistance(minDistance, fabs(dotProduct(direction(1).normalize(), (p[2]-origin).normalize())));
+    return quadraticSignedDistance(p, origin, param);
 }
 
 SignedDistance CubicSegment::signedDistance(Point2 origin, double &param) const {
-    Vector2 qa = p[0]-origin;
-    Vector2 ab = p[1]-p[0];
-    Vector2 br = p[2]-p[1]-ab;
-    Vector2 as = (p[3]-p[2])-(p[2]-p[1])-br;
-
-    Vector2 epDir = direction(0);
-    double minDistance = nonZeroSign(crossProduct(epDir, qa))*qa.length(); // distance from A
-    param = -dotProduct(qa, epDir)/dotProduct(epDir, epDir);
-    {
-        epDir = direction(1);
-        double distance = (p[3]-origin).length(); // distance from B
-        if (distance < fabs(minDistance)) {
-            minDistance = nonZeroSign(crossProduct(epDir, p[3]-origin))*distance;
-            param = dotProduct(epDir-(p[3]-origin), epDir)/dotProduct(epDir, epDir);
-        }
-    }
-    // Iterative minimum distance search
-    for (int i = 0; i <= MSDFGEN_CUBIC_SEARCH_STARTS; ++i) {
-        double t = (double) i/MSDFGEN_CUBIC_SEARCH_STARTS;
-        Vector2 qe = qa+3*t*ab+3*t*t*br+t*t*t*as;
-        for (int step = 0; step < MSDFGEN_CUBIC_SEARCH_STEPS; ++step) {
-            // Improve t
-            Vector2 d1 = 3*ab+6*t*br+3*t*t*as;
-            Vector2 d2 = 6*br+6*t*as;
-            t -= dotProduct(qe, d1)/(dotProduct(d1, d1)+dotProduct(qe, d2));
-            if (t <= 0 || t >= 1)
-                break;
-            qe = qa+3*t*ab+3*t*t*br+t*t*t*as;
-            double distance = qe.length();
-            if (distance < fabs(minDistance)) {
-                minDistance = nonZeroSign(crossProduct(d1, qe))*distance;
-                param = t;
-            }
-        }
-    }
-
-    if (param >= 0 && param <= 1)
-        return SignedDistance(minDistance, 0);
-    if (param < .5)
-        return SignedDistance(minDistance, fabs(dotProduct(direction(0).normalize(), qa.normalize())));
-    else
-        return SignedDistance(minDistance, fabs(dotProduct(direction(1).normalize(), (p[3]-origin).normalize())));
+    return cubicSignedDistance(p, origin, param);
 }
 
 int LinearSegment::scanlineIntersections(double x[3], int dy[3], double y) const {
@@ -8,7 +8,10 @@
 namespace msdfgen {
 
 // Parameters for iterative search of closest point on a cubic Bezier curve. Increase for higher precision.
+// The number of starting intervals is MSDFGEN_CUBIC_SEARCH_STARTS per quarter turn of the curve's control polygon, within the given bounds.
 #define MSDFGEN_CUBIC_SEARCH_STARTS 4
+#define MSDFGEN_CUBIC_SEARCH_MIN_STARTS 2
+#define MSDFGEN_CUBIC_SEARCH_MAX_STARTS 12
 #define MSDFGEN_CUBIC_SEARCH_STEPS 4
 
 /// An abstract edge segment.
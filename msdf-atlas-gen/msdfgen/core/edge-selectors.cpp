@@ -2,6 +2,7 @@
 #include "edge-selectors.h"
 
 #include "arithmetics.hpp"
+#include "FlatShape.h"
 
 namespace msdfgen {
 
@@ -15,7 +16,7 @@ void TrueDistanceSelector::reset(const Point2 &p) {
     this->p = p;
 }
 
-void TrueDistanceSelector::addEdge(EdgeCache &cache, const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge) {
+void TrueDistanceSelector::addEdge(EdgeCache &cache, const EdgeSegment *, const EdgeSegment *edge, const EdgeSegment *) {
     double delta = DISTANCE_DELTA_FACTOR*(p-cache.point).length();
     if (cache.absDistance-delta <= fabs(minDistance.distance)) {
         double dummy;
@@ -27,6 +28,26 @@ void TrueDistanceSelector::addEdge(EdgeCache &cache, const EdgeSegment *prevEdge
     }
 }
 
+void TrueDistanceSelector::addEdge(EdgeCache &cache, const FlatShape &shape, int edge) {
+    if (needsEdgeDistance(cache, shape, edge)) {
+        double dummy;
+        SignedDistance distance = shape.signedDistance<double>(edge, p, dummy);
+        addEdgeDistance(cache, shape, edge, distance, dummy);
+    }
+}
+
+bool TrueDistanceSelector::needsEdgeDistance(const EdgeCache &cache, const FlatShape &, int) const {
+    double delta = DISTANCE_DELTA_FACTOR*(p-cache.point).length();
+    return cache.absDistance-delta <= fabs(minDistance.distance);
+}
+
+void TrueDistanceSelector::addEdgeDistance(EdgeCache &cache, const FlatShape &, int, const SignedDistance &distance, double) {
+    if (distance < minDistance)
+        minDistance = distance;
+    cache.point = p;
+    cache.absDistance = fabs(distance.distance);
+}
+
 void TrueDistanceSelector::merge(const TrueDistanceSelector &other) {
     if (other.minDistance < minDistance)
         minDistance = other.minDistance;
@@ -60,7 +81,7 @@ void PseudoDistanceSelectorBase::reset(double delta) {
     nearEdgeParam = 0;
 }
 
-bool PseudoDistanceSelectorBase::isEdgeRelevant(const EdgeCache &cache, const EdgeSegment *edge, const Point2 &p) const {
+bool PseudoDistanceSelectorBase::isEdgeRelevant(const EdgeCache &cache, const EdgeSegment *, const Point2 &p) const {
     double delta = DISTANCE_DELTA_FACTOR*(p-cache.point).length();
     return (
         cache.absDistance-delta <= fabs(minTrueDistance.distance) ||
@@ -158,6 +179,43 @@ void PseudoDistanceSelector::addEdge(EdgeCache &cache, const EdgeSegment *prevEd
     }
 }
 
+void PseudoDistanceSelector::addEdge(EdgeCache &cache, const FlatShape &shape, int edge) {
+    if (needsEdgeDistance(cache, shape, edge)) {
+        double param;
+        SignedDistance distance = shape.signedDistance<double>(edge, p, param);
+        addEdgeDistance(cache, shape, edge, distance, param);
+    }
+}
+
+bool PseudoDistanceSelector::needsEdgeDistance(const EdgeCache &cache, const FlatShape &shape, int edge) const {
+    return isEdgeRelevant(cache, shape.segment(edge), p);
+}
+
+void PseudoDistanceSelector::addEdgeDistance(EdgeCache &cache, const FlatShape &shape, int edge, const SignedDistance &distance, double param) {
+    addEdgeTrueDistance(shape.segment(edge), distance, param);
+    cache.point = p;
+    cache.absDistance = fabs(distance.distance);
+
+    Vector2 ap = p-shape.startPoint(edge);
+    Vector2 bp = p-shape.endPoint(edge);
+    double add = dotProduct(ap, shape.startBisector(edge));
+    double bdd = -dotProduct(bp, shape.endBisector(edge));
+    if (add > 0) {
+        double pd = distance.distance;
+        if (getPseudoDistance(pd, ap, -shape.startDirection(edge)))
+            addEdgePseudoDistance(pd = -pd);
+        cache.aPseudoDistance = pd;
+    }
+    if (bdd > 0) {
+        double pd = distance.distance;
+        if (getPseudoDistance(pd, bp, shape.endDirection(edge)))
+            addEdgePseudoDistance(pd);
+        cache.bPseudoDistance = pd;
+    }
+    cache.aDomainDistance = add;
+    cache.bDomainDistance = bdd;
+}
+
 PseudoDistanceSelector::DistanceType PseudoDistanceSelector::distance() const {
     return computeDistance(p);
 }
@@ -225,6 +283,69 @@ void MultiDistanceSelector::addEdge(EdgeCache &cache, const EdgeSegment *prevEdg
     }
 }
 
+void MultiDistanceSelector::addEdge(EdgeCache &cache, const FlatShape &shape, int edge) {
+    if (needsEdgeDistance(cache, shape, edge)) {
+        double param;
+        SignedDistance distance = shape.signedDistance<double>(edge, p, param);
+        addEdgeDistance(cache, shape, edge, distance, param);
+    }
+}
+
+bool MultiDistanceSelector::needsEdgeDistance(const EdgeCache &cache, const FlatShape &shape, int edge) const {
+    const EdgeSegment *segment = shape.segment(edge);
+    EdgeColor color = shape.color(edge);
+    return (
+        (color&RED && r.isEdgeRelevant(cache, segment, p)) ||
+        (color&GREEN && g.isEdgeRelevant(cache, segment, p)) ||
+        (color&BLUE && b.isEdgeRelevant(cache, segment, p))
+    );
+}
+
+void MultiDistanceSelector::addEdgeDistance(EdgeCache &cache, const FlatShape &shape, int edge, const SignedDistance &distance, double param) {
+    const EdgeSegment *segment = shape.segment(edge);
+    EdgeColor color = shape.color(edge);
+    if (color&RED)
+        r.addEdgeTrueDistance(segment, distance, param);
+    if (color&GREEN)
+        g.addEdgeTrueDistance(segment, distance, param);
+    if (color&BLUE)
+        b.addEdgeTrueDistance(segment, distance, param);
+    cache.point = p;
+    cache.absDistance = fabs(distance.distance);
+
+    Vector2 ap = p-shape.startPoint(edge);
+    Vector2 bp = p-shape.endPoint(edge);
+    double add = dotProduct(ap, shape.startBisector(edge));
+    double bdd = -dotProduct(bp, shape.endBisector(edge));
+    if (add > 0) {
+        double pd = distance.distance;
+        if (PseudoDistanceSelectorBase::getPseudoDistance(pd, ap, -shape.startDirection(edge))) {
+            pd = -pd;
+            if (color&RED)
+                r.addEdgePseudoDistance(pd);
+            if (color&GREEN)
+                g.addEdgePseudoDistance(pd);
+            if (color&BLUE)
+                b.addEdgePseudoDistance(pd);
+        }
+        cache.aPseudoDistance = pd;
+    }
+    if (bdd > 0) {
+        double pd = distance.distance;
+        if (PseudoDistanceSelectorBase::getPseudoDistance(pd, bp, shape.endDirection(edge))) {
+            if (color&RED)
+                r.addEdgePseudoDistance(pd);
+            if (color&GREEN)
+                g.addEdgePseudoDistance(pd);
+            if (color&BLUE)
+                b.addEdgePseudoDistance(pd);
+        }
+        cache.bPseudoDistance = pd;
+    }
+    cache.aDomainDistance = add;
+    cache.bDomainDistance = bdd;
+}
+
 void MultiDistanceSelector::merge(const MultiDistanceSelector &other) {
     r.merge(other.r);
     g.merge(other.g);
@@ -7,6 +7,8 @@
 
 namespace msdfgen {
 
+class FlatShape;
+
 struct MultiDistance {
     double r, g, b;
 };
@@ -29,6 +31,12 @@ public:
 
     void reset(const Point2 &p);
     void addEdge(EdgeCache &cache, const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge);
+    /// Same as above for the edge of index edge of a FlatShape.
+    void addEdge(EdgeCache &cache, const FlatShape &shape, int edge);
+    /// Returns whether the signed distance of a FlatShape's edge needs to be computed and passed to addEdgeDistance.
+    bool needsEdgeDistance(const EdgeCache &cache, const FlatShape &shape, int edge) const;
+    /// Second part of addEdge for a FlatShape's edge, whose signed distance has been computed separately.
+    void addEdgeDistance(EdgeCache &cache, const FlatShape &shape, int edge, const SignedDistance &distance, double param);
     void merge(const TrueDistanceSelector &other);
     DistanceType distance() const;
 
@@ -78,6 +86,12 @@ public:
 
     void reset(const Point2 &p);
     void addEdge(EdgeCache &cache, const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge);
+    /// Same as above for the edge of index edge of a FlatShape.
+    void addEdge(EdgeCache &cache, const FlatShape &shape, int edge);
+    /// Returns whether the signed distance of a FlatShape's edge needs to be computed and passed to addEdgeDistance.
+    bool needsEdgeDistance(const EdgeCache &cache, const FlatShape &shape, int edge) const;
+    /// Second part of addEdge for a FlatShape's edge, whose signed distance has been computed separately.
+    void addEdgeDistance(EdgeCache &cache, const FlatShape &shape, int edge, const SignedDistance &distance, double param);
     DistanceType distance() const;
 
 private:
@@ -94,6 +108,12 @@ public:
 
     void reset(const Point2 &p);
     void addEdge(EdgeCache &cache, const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge);
+    /// Same as above for the edge of index edge of a FlatShape.
+    void addEdge(EdgeCache &cache, const FlatShape &shape, int edge);
+    /// Returns whether the signed distance of a FlatShape's edge needs to be computed and passed to addEdgeDistance.
+    bool needsEdgeDistance(const EdgeCache &cache, const FlatShape &shape, int edge) const;
+    /// Second part of addEdge for a FlatShape's edge, whose signed distance has been computed separately.
+    void addEdgeDistance(EdgeCache &cache, const FlatShape &shape, int edge, const SignedDistance &distance, double param);
     void merge(const MultiDistanceSelector &other);
     DistanceType distance() const;
     SignedDistance trueDistance() const;
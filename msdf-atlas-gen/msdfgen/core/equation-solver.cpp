@@ -6,9 +6,31 @@
 
 namespace msdfgen {
 
-int solveQuadratic(double x[2], double a, double b, double c) {
+/// Precision-dependent thresholds of the equation solvers.
+template <typename T>
+struct EquationSolverLimits;
+
+template <>
+struct EquationSolverLimits<double> {
+    // Above this ratio of the quadratic and linear coefficients, the equation is treated as linear
+    static double quadraticRatio() { return 1e12; }
+    // Above this ratio of the quadratic and cubic coefficients, the numerical error gets larger than if we treated the cubic coefficient as zero
+    static double cubicRatio() { return 1e6; }
+    // Relative difference of the two real parts below which the equation is considered to have a double root
+    static double doubleRootTolerance() { return 1e-12; }
+};
+
+template <>
+struct EquationSolverLimits<float> {
+    static float quadraticRatio() { return 1e6f; }
+    static float cubicRatio() { return 1e3f; }
+    static float doubleRootTolerance() { return 1e-6f; }
+};
+
+template <typename T>
+static int solveQuadraticImpl(T x[2], T a, T b, T c) {
     // a == 0 -> linear equation
-    if (a == 0 || fabs(b) > 1e12*fabs(a)) {
+    if (a == 0 || std::fabs(b) > EquationSolverLimits<T>::quadraticRatio()*std::fabs(a)) {
         // a == 0, b == 0 -> no solution
         if (b == 0) {
             if (c == 0)
@@ -18,9 +40,9 @@ int solveQuadratic(double x[2], double a, double b, double c) {
         x[0] = -c/b;
         return 1;
     }
-    double dscr = b*b-4*a*c;
+    T dscr = b*b-4*a*c;
     if (dscr > 0) {
-        dscr = sqrt(dscr);
+        dscr = std::sqrt(dscr);
         x[0] = (-b+dscr)/(2*a);
         x[1] = (-b-dscr)/(2*a);
         return 2;
@@ -31,42 +53,60 @@ int solveQuadratic(double x[2], double a, double b, double c) {
         return 0;
 }
 
-static int solveCubicNormed(double x[3], double a, double b, double c) {
-    double a2 = a*a;
-    double q = 1/9.*(a2-3*b);
-    double r = 1/54.*(a*(2*a2-9*b)+27*c);
-    double r2 = r*r;
-    double q3 = q*q*q;
-    a *= 1/3.;
+template <typename T>
+static int solveCubicNormed(T x[3], T a, T b, T c) {
+    T a2 = a*a;
+    T q = T(1/9.)*(a2-3*b);
+    T r = T(1/54.)*(a*(2*a2-9*b)+27*c);
+    T r2 = r*r;
+    T q3 = q*q*q;
+    a *= T(1/3.);
     if (r2 < q3) {
-        double t = r/sqrt(q3);
+        T t = r/std::sqrt(q3);
         if (t < -1) t = -1;
         if (t > 1) t = 1;
-        t = acos(t);
-        q = -2*sqrt(q);
-        x[0] = q*cos(1/3.*t)-a;
-        x[1] = q*cos(1/3.*(t+2*M_PI))-a;
-        x[2] = q*cos(1/3.*(t-2*M_PI))-a;
+        t = std::acos(t);
+        q = -2*std::sqrt(q);
+        x[0] = q*std::cos(T(1/3.)*t)-a;
+        x[1] = q*std::cos(T(1/3.)*(t+T(2*M_PI)))-a;
+        x[2] = q*std::cos(T(1/3.)*(t-T(2*M_PI)))-a;
         return 3;
     } else {
-        double u = (r < 0 ? 1 : -1)*pow(fabs(r)+sqrt(r2-q3), 1/3.); 
-        double v = u == 0 ? 0 : q/u;
+        T u = (r < 0 ? 1 : -1)*std::pow(std::fabs(r)+std::sqrt(r2-q3), T(1/3.));
+        T v = u == 0 ? 0 : q/u;
         x[0] = (u+v)-a;
-        if (u == v || fabs(u-v) < 1e-12*fabs(u+v)) {
-            x[1] = -.5*(u+v)-a;
+        if (u == v || std::fabs(u-v) < EquationSolverLimits<T>::doubleRootTolerance()*std::fabs(u+v)) {
+            x[1] = T(-.5)*(u+v)-a;
             return 2;
         }
         return 1;
     }
 }
 
-int solveCubic(double x[3], double a, double b, double c, double d) {
+template <typename T>
+static int solveCubicImpl(T x[3], T a, T b, T c, T d) {
     if (a != 0) {
-        double bn = b/a;
-        if (fabs(bn) < 1e6) // Above this ratio, the numerical error gets larger than if we treated a as zero
+        T bn = b/a;
+        if (std::fabs(bn) < EquationSolverLimits<T>::cubicRatio())
             return solveCubicNormed(x, bn, c/a, d/a);
     }
-    return solveQuadratic(x, b, c, d);
+    return solveQuadraticImpl(x, b, c, d);
+}
+
+int solveQuadratic(double x[2], double a, double b, double c) {
+    return solveQuadraticImpl(x, a, b, c);
+}
+
+int solveQuadratic(float x[2], float a, float b, float c) {
+    return solveQuadraticImpl(x, a, b, c);
+}
+
+int solveCubic(double x[3], double a, double b, double c, double d) {
+    return solveCubicImpl(x, a, b, c, d);
+}
+
+int solveCubic(float x[3], float a, float b, float c, float d) {
+    return solveCubicImpl(x, a, b, c, d);
 }
 
 }
@@ -4,8 +4,18 @@
 #include <cstdlib>
 #include "BitmapRef.hpp"
 
+#ifndef MSDFGEN_DEFAULT_THREAD_COUNT
+#ifdef MSDFGEN_USE_OPENMP
+#define MSDFGEN_DEFAULT_THREAD_COUNT 0
+#else
+#define MSDFGEN_DEFAULT_THREAD_COUNT 1
+#endif
+#endif
+
 namespace msdfgen {
 
+class GeneratorContext;
+
 /// The configuration of the MSDF error correction pass.
 struct ErrorCorrectionConfig {
     /// The default value of minDeviationRatio.
@@ -47,8 +57,26 @@ struct ErrorCorrectionConfig {
 struct GeneratorConfig {
     /// Specifies whether to use the version of the algorithm that supports overlapping contours with the same winding. May be set to false to improve performance when no such contours are present.
     bool overlapSupport;
+    /// Specifies whether the distances of several adjacent pixels may be computed at once using SIMD instructions if the CPU supports them (AVX2).
+    /// The result may differ from scalar evaluation by rounding errors in the order of 1e-15 relative to the shape's size.
+    bool simd;
+    /// Specifies whether to compute the distances to linear, quadratic and cubic segments in single precision, which is faster but less accurate.
+    /// The error is in the order of 1e-6 relative to the magnitude of the shape's coordinates, which is negligible after quantization to 8 bits per channel
+    /// unless the shape is far from the origin. Single precision computation does not use SIMD instructions.
+    bool singlePrecision;
+    /// The maximum number of threads that may process a single distance field in bands of rows, including the calling thread (0 = one per CPU core).
+    /// Leave at 1 if the calling code already generates several distance fields in parallel. The result does not depend on the number of threads.
+    int threadCount;
+    /// Specifies whether to only compute distances in tiles of pixels within half the range of an edge. All channels of the remaining pixels
+    /// are set to the saturated value 0 or 1 based on the shape's winding (FILL_POSITIVE). True distance fields (SDF) are unaffected after clamping.
+    /// Pseudo-distances are measured to the edges' extended lines and may be within range farther from the edges' bounding boxes,
+    /// so pseudo-distance and multi-channel distance fields are approximate: their values in such pixels change towards saturation, but keep their sign.
+    bool sparse;
+    /// An optional GeneratorContext that provides the temporary memory of the generator and of the error correction pass, which otherwise allocate it for each call.
+    /// It must not be shared by calls made at the same time, e.g. by configurations used by different threads.
+    GeneratorContext *context;
 
-    inline explicit GeneratorConfig(bool overlapSupport = true) : overlapSupport(overlapSupport) { }
+    inline explicit GeneratorConfig(bool overlapSupport = true, bool simd = true, bool singlePrecision = false, int threadCount = MSDFGEN_DEFAULT_THREAD_COUNT, bool sparse = false, GeneratorContext *context = NULL) : overlapSupport(overlapSupport), simd(simd), singlePrecision(singlePrecision), threadCount(threadCount), sparse(sparse), context(context) { }
 };
 
 /// The configuration of the multi-channel distance field generator algorithm.
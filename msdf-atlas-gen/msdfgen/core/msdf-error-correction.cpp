@@ -14,14 +14,21 @@ static void msdfErrorCorrectionInner(const BitmapRef<float, N> &sdf, const Shape
     if (config.errorCorrection.mode == ErrorCorrectionConfig::DISABLED)
         return;
     Bitmap<byte, 1> stencilBuffer;
-    if (!config.errorCorrection.buffer)
-        stencilBuffer = Bitmap<byte, 1>(sdf.width, sdf.height);
     BitmapRef<byte, 1> stencil;
-    stencil.pixels = config.errorCorrection.buffer ? config.errorCorrection.buffer : (byte *) stencilBuffer;
+    if (config.errorCorrection.buffer)
+        stencil.pixels = config.errorCorrection.buffer;
+    else if (config.context)
+        stencil.pixels = config.context->stencilBuffer(sdf.width*sdf.height);
+    else {
+        stencilBuffer = Bitmap<byte, 1>(sdf.width, sdf.height);
+        stencil.pixels = (byte *) stencilBuffer;
+    }
     stencil.width = sdf.width, stencil.height = sdf.height;
     MSDFErrorCorrection ec(stencil, projection, range);
     ec.setMinDeviationRatio(config.errorCorrection.minDeviationRatio);
     ec.setMinImproveRatio(config.errorCorrection.minImproveRatio);
+    ec.setThreadCount(config.threadCount);
+    ec.setContext(config.context);
     switch (config.errorCorrection.mode) {
         case ErrorCorrectionConfig::DISABLED:
         case ErrorCorrectionConfig::INDISCRIMINATE:
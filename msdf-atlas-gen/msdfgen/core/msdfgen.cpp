@@ -2,9 +2,22 @@
 #include "../msdfgen.h"
 
 #include <vector>
+#include <cfloat>
+#include <algorithm>
 #include "edge-selectors.h"
 #include "contour-combiners.h"
 #include "ShapeDistanceFinder.h"
+#include "GridShapeDistanceFinder.h"
+#include "simd-distance.h"
+#include "ThreadPool.h"
+#include "ScanlineSweep.h"
+#include "MSDFSignCorrection.h"
+#include "MSDFErrorCorrection.h"
+
+#ifndef MSDFGEN_HIERARCHY_BLOCK_SIZE
+// Width and height in pixels of the initial cells of the hierarchical MSDF generator.
+#define MSDFGEN_HIERARCHY_BLOCK_SIZE 16
+#endif
 
 namespace msdfgen {
 
@@ -20,6 +33,9 @@ public:
     inline void operator()(float *pixels, double distance) const {
         *pixels = float(invRange*distance+.5);
     }
+    inline void saturate(float *pixels, int sign) const {
+        *pixels = sign > 0 ? 1.f : 0.f;
+    }
 };
 
 template <>
@@ -33,6 +49,9 @@ public:
         pixels[1] = float(invRange*distance.g+.5);
         pixels[2] = float(invRange*distance.b+.5);
     }
+    inline void saturate(float *pixels, int sign) const {
+        pixels[0] = pixels[1] = pixels[2] = sign > 0 ? 1.f : 0.f;
+    }
 };
 
 template <>
@@ -47,63 +66,608 @@ public:
         pixels[2] = float(invRange*distance.b+.5);
         pixels[3] = float(invRange*distance.a+.5);
     }
+    inline void saturate(float *pixels, int sign) const {
+        pixels[0] = pixels[1] = pixels[2] = pixels[3] = sign > 0 ? 1.f : 0.f;
+    }
 };
 
-template <class ContourCombiner>
-void generateDistanceField(const typename DistancePixelConversion<typename ContourCombiner::DistanceType>::BitmapRefType &output, const Shape &shape, const Projection &projection, double range) {
-    DistancePixelConversion<typename ContourCombiner::DistanceType> distancePixelConversion(range);
-#ifdef MSDFGEN_USE_OPENMP
-    #pragma omp parallel
-#endif
-    {
-        ShapeDistanceFinder<ContourCombiner> distanceFinder(shape);
+/// Classifies the tiles of MSDFGEN_TILE_SIZE squared pixels of a distance field for sparse generation (see GeneratorConfig::sparse).
+/// A tile whose pixel centers are all farther than half the range from the bounding box of every edge saturates,
+/// and the sign of its distances is obtained from a scanline through its center. Otherwise, its distances have to be computed.
+/// This bound only holds for true distances, pseudo-distances of saturated tiles may be within range (see GeneratorConfig::sparse).
+class SparseTileMap {
+    GeneratorContext &context;
+    int columns;
+    const signed char *signs;
+public:
+    /// The tile map's memory is held by context.
+    inline explicit SparseTileMap(GeneratorContext &context) : context(context), columns(0), signs(NULL) { }
+    /// Classifies the tiles of a distance field of the specified dimensions.
+    void build(int width, int height, const Shape &shape, const Projection &projection, double range);
+    /// Returns 0 if the distances in the tile containing the pixel have to be computed, or their sign otherwise.
+    inline int sign(int x, int y) const {
+        return signs[y/MSDFGEN_TILE_SIZE*columns+x/MSDFGEN_TILE_SIZE];
+    }
+};
+
+void SparseTileMap::build(int width, int height, const Shape &shape, const Projection &projection, double range) {
+    columns = (width+MSDFGEN_TILE_SIZE-1)/MSDFGEN_TILE_SIZE;
+    int rows = (height+MSDFGEN_TILE_SIZE-1)/MSDFGEN_TILE_SIZE;
+    signed char *tileSigns = context.tileSignBuffer(columns*rows);
+    signs = tileSigns;
+    int edgeCount = shape.edgeCount();
+    Shape::Bounds *edgeBounds = context.edgeBoundsBuffer(edgeCount);
+    int edgeIndex = 0;
+    for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour)
+        for (std::vector<EdgeHolder>::const_iterator edge = contour->edges.begin(); edge != contour->edges.end(); ++edge) {
+            Shape::Bounds &bounds = edgeBounds[edgeIndex++];
+            bounds.l = DBL_MAX, bounds.b = DBL_MAX, bounds.r = -DBL_MAX, bounds.t = -DBL_MAX;
+            (*edge)->bound(bounds.l, bounds.b, bounds.r, bounds.t);
+        }
+    double halfRange = .5*fabs(range);
+    const Shape::Bounds **rowBounds = context.rowBoundsBuffer(edgeCount);
+    ScanlineSweep &sweep = context.scanlineSweep(shape);
+    Scanline &scanline = context.scanline();
+    for (int row = 0; row < rows; ++row) {
+        int y0 = row*MSDFGEN_TILE_SIZE, y1 = min(y0+MSDFGEN_TILE_SIZE, height);
+        double b = projection.unprojectY(y0+.5), t = projection.unprojectY(y1-.5);
+        if (b > t)
+            std::swap(b, t);
+        // Only edges vertically within range of the row of tiles may be near any of them
+        int rowBoundCount = 0;
+        for (const Shape::Bounds *bounds = edgeBounds; bounds < edgeBounds+edgeCount; ++bounds)
+            if (bounds->b-t <= halfRange && b-bounds->t <= halfRange)
+                rowBounds[rowBoundCount++] = bounds;
+        bool scanlineReady = false;
+        for (int column = 0; column < columns; ++column) {
+            int x0 = column*MSDFGEN_TILE_SIZE, x1 = min(x0+MSDFGEN_TILE_SIZE, width);
+            double l = projection.unprojectX(x0+.5), r = projection.unprojectX(x1-.5);
+            if (l > r)
+                std::swap(l, r);
+            bool near = false;
+            for (const Shape::Bounds *const *bounds = rowBounds; bounds < rowBounds+rowBoundCount && !near; ++bounds) {
+                double dx = max(0., max((*bounds)->l-r, l-(*bounds)->r));
+                double dy = max(0., max((*bounds)->b-t, b-(*bounds)->t));
+                near = dx*dx+dy*dy <= halfRange*halfRange;
+            }
+            signed char &sign = tileSigns[row*columns+column];
+            if (near)
+                sign = 0;
+            else {
+                if (!scanlineReady) {
+                    sweep.scanline(scanline, projection.unprojectY(.5*(y0+y1)));
+                    scanlineReady = true;
+                }
+                sign = scanline.filled(projection.unprojectX(.5*(x0+x1)), FILL_POSITIVE) ? 1 : -1;
+            }
+        }
+    }
+}
+
+/// Computes the distance field in bands of MSDFGEN_PARALLEL_BAND_HEIGHT rows, each traversed in serpentine order.
+/// If tiles is not null, pixels of saturated tiles are filled without computing their distances.
+template <class DistanceFinder>
+class DistanceFieldTask : public ThreadPool::Task {
+public:
+    typedef DistanceFinder DistanceFinderType;
+private:
+    typedef DistancePixelConversion<typename DistanceFinder::DistanceType> PixelConversion;
+    const typename PixelConversion::BitmapRefType &output;
+    const Shape &shape;
+    const Projection &projection;
+    PixelConversion distancePixelConversion;
+    const SparseTileMap *tiles;
+public:
+    inline DistanceFieldTask(const typename PixelConversion::BitmapRefType &output, const Shape &shape, const Projection &projection, double range, const SparseTileMap *tiles) : output(output), shape(shape), projection(projection), distancePixelConversion(range), tiles(tiles) { }
+    void work(ThreadPool::Chunks &chunks) {
+        int band;
+        if (!chunks.next(band))
+            return;
+        DistanceFinder distanceFinder(shape);
+        do
+            fillBand(distanceFinder, band);
+        while (chunks.next(band));
+    }
+    void fillBand(DistanceFinder &distanceFinder, int band) {
+        // The band height is even, so each band starts in the same direction as a single serpentine pass over the whole bitmap would
         bool rightToLeft = false;
-#ifdef MSDFGEN_USE_OPENMP
-        #pragma omp for
-#endif
-        for (int y = 0; y < output.height; ++y) {
+        int yEnd = min((band+1)*MSDFGEN_PARALLEL_BAND_HEIGHT, output.height);
+        for (int y = band*MSDFGEN_PARALLEL_BAND_HEIGHT; y < yEnd; ++y) {
             int row = shape.inverseYAxis ? output.height-y-1 : y;
             for (int col = 0; col < output.width; ++col) {
                 int x = rightToLeft ? output.width-col-1 : col;
+                if (int sign = tiles ? tiles->sign(x, y) : 0) {
+                    distancePixelConversion.saturate(output(x, row), sign);
+                    continue;
+                }
                 Point2 p = projection.unproject(Point2(x+.5, y+.5));
-                typename ContourCombiner::DistanceType distance = distanceFinder.distance(p);
+                typename DistanceFinder::DistanceType distance = distanceFinder.distance(p);
                 distancePixelConversion(output(x, row), distance);
             }
             rightToLeft = !rightToLeft;
         }
     }
+};
+
+/// Computes the distance field using GridShapeDistanceFinder in tiles of MSDFGEN_TILE_SIZE squared pixels, traversed row by row
+/// within bands of MSDFGEN_PARALLEL_BAND_HEIGHT rows. Each tile first restricts the finder to its own candidate edges,
+/// so that neighboring pixels share a single list, then its pixels are traversed in serpentine order,
+/// computing the distances of MSDFGEN_SIMD_LANES horizontally adjacent pixels at once if simd is enabled.
+/// If tiles is not null, saturated tiles are filled without computing their distances.
+template <class ContourCombiner, typename Real>
+class TiledDistanceFieldTask : public ThreadPool::Task {
+public:
+    typedef GridShapeDistanceFinder<ContourCombiner, Real> DistanceFinderType;
+private:
+    typedef typename ContourCombiner::DistanceType DistanceType;
+    typedef DistancePixelConversion<DistanceType> PixelConversion;
+    const typename PixelConversion::BitmapRefType &output;
+    const Shape &shape;
+    const Projection &projection;
+    PixelConversion distancePixelConversion;
+    bool simd;
+    const SparseTileMap *tiles;
+public:
+    inline TiledDistanceFieldTask(const typename PixelConversion::BitmapRefType &output, const Shape &shape, const Projection &projection, double range, bool simd, const SparseTileMap *tiles) : output(output), shape(shape), projection(projection), distancePixelConversion(range), simd(simd), tiles(tiles) { }
+    void work(ThreadPool::Chunks &chunks) {
+        int band;
+        if (!chunks.next(band))
+            return;
+        GridShapeDistanceFinder<ContourCombiner, Real> distanceFinder(shape);
+        do
+            fillBand(distanceFinder, band);
+        while (chunks.next(band));
+    }
+    void fillBand(GridShapeDistanceFinder<ContourCombiner, Real> &distanceFinder, int band) {
+        int yEnd = min((band+1)*MSDFGEN_PARALLEL_BAND_HEIGHT, output.height);
+        for (int y0 = band*MSDFGEN_PARALLEL_BAND_HEIGHT; y0 < yEnd; y0 += MSDFGEN_TILE_SIZE) {
+            int y1 = min(y0+MSDFGEN_TILE_SIZE, yEnd);
+            for (int x0 = 0; x0 < output.width; x0 += MSDFGEN_TILE_SIZE) {
+                int x1 = min(x0+MSDFGEN_TILE_SIZE, output.width);
+                if (int sign = tiles ? tiles->sign(x0, y0) : 0) {
+                    for (int y = y0; y < y1; ++y) {
+                        int row = shape.inverseYAxis ? output.height-y-1 : y;
+                        for (int x = x0; x < x1; ++x)
+                            distancePixelConversion.saturate(output(x, row), sign);
+                    }
+                    continue;
+                }
+                // The projection is monotonic along each axis, so the tile's outermost pixel centers bound all of its pixel centers
+                Point2 a = projection.unproject(Point2(x0+.5, y0+.5)), b = projection.unproject(Point2(x1-.5, y1-.5));
+                distanceFinder.setTile(Point2(min(a.x, b.x), min(a.y, b.y)), Point2(max(a.x, b.x), max(a.y, b.y)));
+                if (simd)
+                    fillTileSIMD(distanceFinder, x0, y0, x1, y1);
+                else
+                    fillTile(distanceFinder, x0, y0, x1, y1);
+            }
+        }
+    }
+private:
+    void fillTile(GridShapeDistanceFinder<ContourCombiner, Real> &distanceFinder, int x0, int y0, int x1, int y1) {
+        bool rightToLeft = false;
+        for (int y = y0; y < y1; ++y) {
+            int row = shape.inverseYAxis ? output.height-y-1 : y;
+            for (int col = x0; col < x1; ++col) {
+                int x = rightToLeft ? x0+x1-col-1 : col;
+                Point2 p = projection.unproject(Point2(x+.5, y+.5));
+                DistanceType distance = distanceFinder.distance(p);
+                distancePixelConversion(output(x, row), distance);
+            }
+            rightToLeft = !rightToLeft;
+        }
+    }
+    void fillTileSIMD(GridShapeDistanceFinder<ContourCombiner, Real> &distanceFinder, int x0, int y0, int x1, int y1) {
+        bool rightToLeft = false;
+        for (int y = y0; y < y1; ++y) {
+            int row = shape.inverseYAxis ? output.height-y-1 : y;
+            // Each batch covers MSDFGEN_SIMD_LANES horizontally adjacent pixels
+            for (int col = x0; col < x1; col += MSDFGEN_SIMD_LANES) {
+                int count = min(MSDFGEN_SIMD_LANES, x1-col);
+                int x[MSDFGEN_SIMD_LANES];
+                Point2 p[MSDFGEN_SIMD_LANES];
+                DistanceType distances[MSDFGEN_SIMD_LANES];
+                for (int i = 0; i < count; ++i) {
+                    x[i] = rightToLeft ? x0+x1-col-i-1 : col+i;
+                    p[i] = projection.unproject(Point2(x[i]+.5, y+.5));
+                }
+                distanceFinder.distances(distances, p, count);
+                for (int i = 0; i < count; ++i)
+                    distancePixelConversion(output(x[i], row), distances[i]);
+            }
+            rightToLeft = !rightToLeft;
+        }
+    }
+};
+
+static int bandCount(int height) {
+    return (height+MSDFGEN_PARALLEL_BAND_HEIGHT-1)/MSDFGEN_PARALLEL_BAND_HEIGHT;
+}
+
+/// Receives the rows of a distance field as they are generated.
+class GeneratedRowSink {
+public:
+    virtual ~GeneratedRowSink() { }
+    /// Called once the first rowCount rows of the bitmap, in the order of its memory, have been generated.
+    virtual void rowsGenerated(int rowCount) = 0;
+};
+
+/// Processes the bands of a distance field task on the calling thread in the order of the bitmap's rows, passing each finished band to sink.
+/// The result is the same as that of ThreadPool::run, as the distance finders do not depend on the order of queries.
+template <class FillTask>
+static void fillDistanceFieldRows(FillTask &task, const Shape &shape, int height, GeneratedRowSink &sink) {
+    typename FillTask::DistanceFinderType distanceFinder(shape);
+    int bands = bandCount(height);
+    for (int i = 0; i < bands; ++i) {
+        // With an inverted Y axis, the last band holds the first rows of the bitmap
+        int band = shape.inverseYAxis ? bands-i-1 : i;
+        task.fillBand(distanceFinder, band);
+        sink.rowsGenerated(shape.inverseYAxis ? height-band*MSDFGEN_PARALLEL_BAND_HEIGHT : min((band+1)*MSDFGEN_PARALLEL_BAND_HEIGHT, height));
+    }
+}
+
+template <class DistanceFinder>
+void fillDistanceField(const typename DistancePixelConversion<typename DistanceFinder::DistanceType>::BitmapRefType &output, const Shape &shape, const Projection &projection, double range, const SparseTileMap *tiles, int threadCount, GeneratedRowSink *sink) {
+    DistanceFieldTask<DistanceFinder> task(output, shape, projection, range, tiles);
+    if (sink)
+        fillDistanceFieldRows(task, shape, output.height, *sink);
+    else
+        ThreadPool::run(task, bandCount(output.height), threadCount);
+}
+
+template <class ContourCombiner, typename Real>
+void fillDistanceFieldTiled(const typename DistancePixelConversion<typename ContourCombiner::DistanceType>::BitmapRefType &output, const Shape &shape, const Projection &projection, double range, bool simd, const SparseTileMap *tiles, int threadCount, GeneratedRowSink *sink) {
+    TiledDistanceFieldTask<ContourCombiner, Real> task(output, shape, projection, range, simd, tiles);
+    if (sink)
+        fillDistanceFieldRows(task, shape, output.height, *sink);
+    else
+        ThreadPool::run(task, bandCount(output.height), threadCount);
+}
+
+/// Generates the distance field using the fastest applicable distance finder. If sink is not null, it is generated on the calling thread and passed to sink row by row.
+template <class ContourCombiner>
+void generateDistanceField(const typename DistancePixelConversion<typename ContourCombiner::DistanceType>::BitmapRefType &output, const Shape &shape, const Projection &projection, double range, const GeneratorConfig &config, GeneratedRowSink *sink = NULL) {
+    // All finders produce identical results, the grid only pays off once there are enough edges to skip
+    bool grid = shape.edgeCount() >= MSDFGEN_GRID_FINDER_MIN_EDGES;
+    GeneratorContext localContext;
+    SparseTileMap tileMap(config.context ? *config.context : localContext);
+    const SparseTileMap *tiles = NULL;
+    if (config.sparse) {
+        tileMap.build(output.width, output.height, shape, projection, range);
+        tiles = &tileMap;
+    }
+    if (config.singlePrecision) {
+        if (grid)
+            fillDistanceFieldTiled<ContourCombiner, float>(output, shape, projection, range, false, tiles, config.threadCount, sink);
+        else
+            fillDistanceField<FlatShapeDistanceFinder<ContourCombiner, float> >(output, shape, projection, range, tiles, config.threadCount, sink);
+    } else if (grid)
+        fillDistanceFieldTiled<ContourCombiner, double>(output, shape, projection, range, config.simd && simdDistanceSupported(), tiles, config.threadCount, sink);
+    else
+        fillDistanceField<FlatShapeDistanceFinder<ContourCombiner> >(output, shape, projection, range, tiles, config.threadCount, sink);
+}
+
+/// Generates a block of an MSDF by recursively subdividing it, starting from its four corners, into cells which can be bilinearly interpolated.
+/// Each cell is probed at the corners of its four potential subcells. It is subdivided unless the true distance of its middle pixel shows that no edge
+/// passes through it, the medians and (except beyond the range) all channels of the probes are on the same side of 0.5, and interpolating the probes
+/// from the cell's corners is accurate within tolerance.
+template <class DistanceFinder>
+class HierarchicalMSDFBlock {
+    DistanceFinder distanceFinder;
+    const Projection &projection;
+    double invRange, halfRange;
+    double tolerance;
+    Vector2 pixelSize;
+    int x0, y0, width;
+    // Channel values, true distances, and whether they have been computed, of the block's pixels
+    std::vector<float> values;
+    std::vector<double> trueDistances;
+    std::vector<char> known;
+
+public:
+    HierarchicalMSDFBlock(const Shape &shape, const Projection &projection, double range, double tolerance) : distanceFinder(shape), projection(projection), invRange(1/range), halfRange(.5*fabs(range)), tolerance(tolerance), pixelSize(projection.unprojectVector(Vector2(1))), x0(0), y0(0), width(0) {
+        pixelSize = Vector2(fabs(pixelSize.x), fabs(pixelSize.y));
+        values.resize(3*(MSDFGEN_HIERARCHY_BLOCK_SIZE+1)*(MSDFGEN_HIERARCHY_BLOCK_SIZE+1));
+        trueDistances.resize((MSDFGEN_HIERARCHY_BLOCK_SIZE+1)*(MSDFGEN_HIERARCHY_BLOCK_SIZE+1));
+        known.resize((MSDFGEN_HIERARCHY_BLOCK_SIZE+1)*(MSDFGEN_HIERARCHY_BLOCK_SIZE+1));
+    }
+
+    /// Generates the block spanning pixels x0 to x1 and y0 to y1 inclusive, and outputs the pixels before x1 and y1, or up to them if outputX1 or outputY1 is set.
+    void generate(const BitmapRef<float, 3> &output, bool inverseYAxis, int x0, int y0, int x1, int y1, bool outputX1, bool outputY1) {
+        this->x0 = x0, this->y0 = y0;
+        width = x1-x0+1;
+        std::fill(known.begin(), known.end(), 0);
+        sample(x0, y0), sample(x1, y0), sample(x0, y1), sample(x1, y1);
+        refine(x0, y0, x1, y1);
+        int xEnd = outputX1 ? x1+1 : x1, yEnd = outputY1 ? y1+1 : y1;
+        for (int y = y0; y < yEnd; ++y) {
+            int row = inverseYAxis ? output.height-y-1 : y;
+            for (int x = x0; x < xEnd; ++x) {
+                const float *src = value(x, y);
+                float *dst = output(x, row);
+                dst[0] = src[0], dst[1] = src[1], dst[2] = src[2];
+            }
+        }
+    }
+
+private:
+    inline int index(int x, int y) const {
+        return (y-y0)*width+x-x0;
+    }
+
+    inline float * value(int x, int y) {
+        return &values[3*index(x, y)];
+    }
+
+    static inline float median(const float *v) {
+        return msdfgen::median(v[0], v[1], v[2]);
+    }
+
+    static inline float clamped(float v) {
+        return clamp(v, 0.f, 1.f);
+    }
+
+    void sample(int x, int y) {
+        int i = index(x, y);
+        if (known[i])
+            return;
+        MultiAndTrueDistance distance = distanceFinder.distance(projection.unproject(Point2(x+.5, y+.5)));
+        // Same conversion as in the non-hierarchical generator
+        values[3*i] = float(invRange*distance.r+.5);
+        values[3*i+1] = float(invRange*distance.g+.5);
+        values[3*i+2] = float(invRange*distance.b+.5);
+        trueDistances[i] = distance.a;
+        known[i] = 1;
+    }
+
+    /// Decides whether the cell spanning xs[0] to xs[2] and ys[0] to ys[2] may be interpolated, given the samples at all combinations of xs and ys.
+    bool interpolable(const int *xs, const int *ys) {
+        // No edge may pass within the cell, whose pixels are all within reach of the middle pixel
+        double reach = Vector2(max(xs[1]-xs[0], xs[2]-xs[1])*pixelSize.x, max(ys[1]-ys[0], ys[2]-ys[1])*pixelSize.y).length();
+        double distance = fabs(trueDistances[index(xs[1], ys[1])]);
+        if (distance <= reach)
+            return false;
+        bool inside = median(value(xs[1], ys[1])) > .5f;
+        // Channels on opposite sides of 0.5 encode a corner, unless beyond the range where they may saturate without affecting the median.
+        // Beyond the range, interpolation errors are also only measured after clamping, while within it, the saturated probes still reveal curvature.
+        bool inRange = distance-reach < halfRange;
+        const float *corners[4] = { value(xs[0], ys[0]), value(xs[2], ys[0]), value(xs[0], ys[2]), value(xs[2], ys[2]) };
+        for (int j = 0; j < 3; ++j) {
+            double ty = ys[2] > ys[0] ? double(ys[j]-ys[0])/(ys[2]-ys[0]) : 0;
+            for (int i = 0; i < 3; ++i) {
+                const float *v = value(xs[i], ys[j]);
+                if ((median(v) > .5f) != inside)
+                    return false;
+                if (inRange && ((v[0] > .5f) != inside || (v[1] > .5f) != inside || (v[2] > .5f) != inside))
+                    return false;
+                double tx = xs[2] > xs[0] ? double(xs[i]-xs[0])/(xs[2]-xs[0]) : 0;
+                for (int c = 0; c < 3; ++c) {
+                    double estimate = mix(mix(corners[0][c], corners[1][c], tx), mix(corners[2][c], corners[3][c], tx), ty);
+                    if (inRange ? fabs(estimate-v[c]) > tolerance : fabs(clamped(float(estimate))-clamped(v[c])) > tolerance)
+                        return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void interpolate(int cx0, int cy0, int cx1, int cy1) {
+        const float *corners[4] = { value(cx0, cy0), value(cx1, cy0), value(cx0, cy1), value(cx1, cy1) };
+        for (int y = cy0; y <= cy1; ++y) {
+            double ty = cy1 > cy0 ? double(y-cy0)/(cy1-cy0) : 0;
+            for (int x = cx0; x <= cx1; ++x) {
+                if (known[index(x, y)])
+                    continue;
+                double tx = cx1 > cx0 ? double(x-cx0)/(cx1-cx0) : 0;
+                float *v = value(x, y);
+                for (int c = 0; c < 3; ++c)
+                    v[c] = float(mix(mix(corners[0][c], corners[1][c], tx), mix(corners[2][c], corners[3][c], tx), ty));
+            }
+        }
+    }
+
+    void refine(int cx0, int cy0, int cx1, int cy1) {
+        if (cx1-cx0 <= 1 && cy1-cy0 <= 1)
+            return;
+        // The cell is probed at the corners of its potential subcells, only splitting dimensions longer than one pixel
+        int xs[3] = { cx0, (cx0+cx1)>>1, cx1 }, ys[3] = { cy0, (cy0+cy1)>>1, cy1 };
+        int nx = 2, ny = 2;
+        if (cx1-cx0 <= 1)
+            xs[1] = cx1, nx = 1;
+        if (cy1-cy0 <= 1)
+            ys[1] = cy1, ny = 1;
+        for (int j = 0; j < 3; ++j)
+            for (int i = 0; i < 3; ++i)
+                sample(xs[i], ys[j]);
+        if (interpolable(xs, ys)) {
+            interpolate(cx0, cy0, cx1, cy1);
+            return;
+        }
+        for (int j = 0; j < ny; ++j)
+            for (int i = 0; i < nx; ++i)
+                refine(xs[i], ys[j], xs[i+1], ys[j+1]);
+    }
+
+};
+
+/// Generates an MSDF hierarchically in rows of blocks of MSDFGEN_HIERARCHY_BLOCK_SIZE squared pixels, whose corners are shared with neighboring blocks.
+/// Each block only outputs the pixels that do not belong to the blocks after it, so the result does not depend on the order in which they are processed.
+template <class DistanceFinder>
+class HierarchicalMSDFTask : public ThreadPool::Task {
+    const BitmapRef<float, 3> &output;
+    const Shape &shape;
+    const Projection &projection;
+    double range;
+    double tolerance;
+public:
+    inline HierarchicalMSDFTask(const BitmapRef<float, 3> &output, const Shape &shape, const Projection &projection, double range, double tolerance) : output(output), shape(shape), projection(projection), range(range), tolerance(tolerance) { }
+    void work(ThreadPool::Chunks &chunks) {
+        int blockRow;
+        if (!chunks.next(blockRow))
+            return;
+        HierarchicalMSDFBlock<DistanceFinder> block(shape, projection, range, tolerance);
+        do {
+            int y0 = blockRow*MSDFGEN_HIERARCHY_BLOCK_SIZE;
+            int y1 = max(min(y0+MSDFGEN_HIERARCHY_BLOCK_SIZE, output.height-1), y0);
+            for (int x0 = 0; x0 == 0 || x0 < output.width-1; x0 += MSDFGEN_HIERARCHY_BLOCK_SIZE) {
+                int x1 = max(min(x0+MSDFGEN_HIERARCHY_BLOCK_SIZE, output.width-1), x0);
+                block.generate(output, shape.inverseYAxis, x0, y0, x1, y1, x1 == output.width-1, y1 == output.height-1);
+            }
+        } while (chunks.next(blockRow));
+    }
+};
+
+template <class DistanceFinder>
+void fillHierarchicalMSDF(const BitmapRef<float, 3> &output, const Shape &shape, const Projection &projection, double range, double tolerance, int threadCount) {
+    HierarchicalMSDFTask<DistanceFinder> task(output, shape, projection, range, tolerance);
+    int blockRows = max((output.height-2)/MSDFGEN_HIERARCHY_BLOCK_SIZE+1, 1);
+    ThreadPool::run(task, blockRows, threadCount);
+}
+
+template <class ContourCombiner>
+void generateHierarchicalMSDF(const BitmapRef<float, 3> &output, const Shape &shape, const Projection &projection, double range, const GeneratorConfig &config, double tolerance) {
+    if (output.width <= 0 || output.height <= 0)
+        return;
+    if (shape.edgeCount() >= MSDFGEN_GRID_FINDER_MIN_EDGES)
+        fillHierarchicalMSDF<GridShapeDistanceFinder<ContourCombiner> >(output, shape, projection, range, tolerance, config.threadCount);
+    else
+        fillHierarchicalMSDF<FlatShapeDistanceFinder<ContourCombiner> >(output, shape, projection, range, tolerance, config.threadCount);
+}
+
+/// Corrects the signs and then the artifacts of an MSDF's rows as they are generated, so that each row is processed while it is still in cache.
+/// Each stage lags behind the previous one by a row, which the neighborhoods of its texels extend into, so that its input is already final
+/// and the result is the same as that of distanceSignCorrection followed by msdfErrorCorrection without the distance check.
+template <int N>
+class SignCorrectionStream : public GeneratedRowSink {
+    const BitmapRef<float, N> &output;
+    bool inverseYAxis;
+    MSDFSignCorrection signCorrection;
+    ScanlineSweep &sweep;
+    Scanline &scanline;
+    // Whether each row has ambiguous texels, which are resolved once its neighbors have been corrected
+    char *ambiguousRows;
+    MSDFErrorCorrection *errorCorrection;
+    bool protectEdges;
+    // Number of rows from the start of the bitmap whose signs have been corrected, which are final, whose errors have been found, and which have been corrected
+    int correctedRows, finalRows, checkedRows, appliedRows;
+
+    // Returns the number of rows that a stage can process once the previous stage has processed rowCount rows
+    inline int stageEnd(int rowCount) const {
+        return rowCount == output.height ? rowCount : max(rowCount-1, 0);
+    }
+
+public:
+    SignCorrectionStream(const BitmapRef<float, N> &output, const Shape &shape, const Projection &projection, FillRule fillRule, GeneratorContext &context, MSDFErrorCorrection *errorCorrection, bool protectEdges) :
+        output(output), inverseYAxis(shape.inverseYAxis), signCorrection(context.matchMapBuffer(output.width*output.height), shape, projection, fillRule),
+        sweep(context.scanlineSweep(shape)), scanline(context.scanline()), ambiguousRows(context.bandBuffer(output.height)),
+        errorCorrection(errorCorrection), protectEdges(protectEdges), correctedRows(0), finalRows(0), checkedRows(0), appliedRows(0) { }
+
+    void rowsGenerated(int rowCount) {
+        // The sign correction counts rows in the direction of the shape's Y axis
+        for (; correctedRows < rowCount; ++correctedRows) {
+            int y = inverseYAxis ? output.height-correctedRows-1 : correctedRows;
+            ambiguousRows[correctedRows] = signCorrection.correctRow(output, sweep, scanline, y);
+        }
+        for (int finalEnd = stageEnd(correctedRows); finalRows < finalEnd; ++finalRows) {
+            if (ambiguousRows[finalRows])
+                signCorrection.resolveRow(output, inverseYAxis ? output.height-finalRows-1 : finalRows);
+        }
+        if (errorCorrection) {
+            int checkEnd = stageEnd(finalRows);
+            if (protectEdges)
+                errorCorrection->protectEdges(BitmapConstRef<float, N>(output), checkedRows, checkEnd);
+            errorCorrection->findErrors(BitmapConstRef<float, N>(output), checkedRows, checkEnd);
+            checkedRows = checkEnd;
+            int applyEnd = stageEnd(checkedRows);
+            errorCorrection->apply(output, appliedRows, applyEnd);
+            appliedRows = applyEnd;
+        }
+    }
+};
+
+template <class ContourCombiner, int N>
+void generateSignCorrectedDistanceField(const BitmapRef<float, N> &output, const Shape &shape, const Projection &projection, double range, const MSDFGeneratorConfig &config, FillRule fillRule) {
+    const ErrorCorrectionConfig &ecConfig = config.errorCorrection;
+    if (config.threadCount != 1) {
+        // Separate passes can be parallelized in bands
+        generateDistanceField<ContourCombiner>(output, shape, projection, range, config);
+        distanceSignCorrection(output, shape, projection, fillRule, config.threadCount, config.context);
+        MSDFGeneratorConfig errorCorrectionConfig = config;
+        errorCorrectionConfig.errorCorrection.distanceCheckMode = ErrorCorrectionConfig::DO_NOT_CHECK_DISTANCE;
+        msdfErrorCorrection(output, shape, projection, range, errorCorrectionConfig);
+        return;
+    }
+    if (output.width <= 0 || output.height <= 0)
+        return;
+    GeneratorContext localContext;
+    GeneratorContext &context = config.context ? *config.context : localContext;
+    MSDFErrorCorrection errorCorrection;
+    if (ecConfig.mode != ErrorCorrectionConfig::DISABLED) {
+        BitmapRef<byte, 1> stencil(ecConfig.buffer ? ecConfig.buffer : context.stencilBuffer(output.width*output.height), output.width, output.height);
+        errorCorrection = MSDFErrorCorrection(stencil, projection, range);
+        errorCorrection.setMinDeviationRatio(ecConfig.minDeviationRatio);
+        errorCorrection.setMinImproveRatio(ecConfig.minImproveRatio);
+        errorCorrection.setContext(&context);
+        if (ecConfig.mode == ErrorCorrectionConfig::EDGE_PRIORITY)
+            errorCorrection.protectCorners(shape);
+        else if (ecConfig.mode == ErrorCorrectionConfig::EDGE_ONLY)
+            errorCorrection.protectAll();
+    }
+    SignCorrectionStream<N> stream(output, shape, projection, fillRule, context, ecConfig.mode != ErrorCorrectionConfig::DISABLED ? &errorCorrection : NULL, ecConfig.mode == ErrorCorrectionConfig::EDGE_PRIORITY);
+    generateDistanceField<ContourCombiner>(output, shape, projection, range, config, &stream);
 }
 
 void generateSDF(const BitmapRef<float, 1> &output, const Shape &shape, const Projection &projection, double range, const GeneratorConfig &config) {
     if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<TrueDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<OverlappingContourCombiner<TrueDistanceSelector> >(output, shape, projection, range, config);
     else
-        generateDistanceField<SimpleContourCombiner<TrueDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<SimpleContourCombiner<TrueDistanceSelector> >(output, shape, projection, range, config);
 }
 
 void generatePseudoSDF(const BitmapRef<float, 1> &output, const Shape &shape, const Projection &projection, double range, const GeneratorConfig &config) {
     if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<PseudoDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<OverlappingContourCombiner<PseudoDistanceSelector> >(output, shape, projection, range, config);
     else
-        generateDistanceField<SimpleContourCombiner<PseudoDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<SimpleContourCombiner<PseudoDistanceSelector> >(output, shape, projection, range, config);
 }
 
 void generateMSDF(const BitmapRef<float, 3> &output, const Shape &shape, const Projection &projection, double range, const MSDFGeneratorConfig &config) {
     if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<MultiDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<OverlappingContourCombiner<MultiDistanceSelector> >(output, shape, projection, range, config);
+    else
+        generateDistanceField<SimpleContourCombiner<MultiDistanceSelector> >(output, shape, projection, range, config);
+    msdfErrorCorrection(output, shape, projection, range, config);
+}
+
+void generateMSDF(const BitmapRef<float, 3> &output, const Shape &shape, const Projection &projection, double range, const MSDFGeneratorConfig &config, double tolerance) {
+    if (config.overlapSupport)
+        generateHierarchicalMSDF<OverlappingContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, projection, range, config, tolerance);
     else
-        generateDistanceField<SimpleContourCombiner<MultiDistanceSelector> >(output, shape, projection, range);
+        generateHierarchicalMSDF<SimpleContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, projection, range, config, tolerance);
     msdfErrorCorrection(output, shape, projection, range, config);
 }
 
 void generateMTSDF(const BitmapRef<float, 4> &output, const Shape &shape, const Projection &projection, double range, const MSDFGeneratorConfig &config) {
     if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<OverlappingContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, projection, range, config);
     else
-        generateDistanceField<SimpleContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<SimpleContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, projection, range, config);
     msdfErrorCorrection(output, shape, projection, range, config);
 }
 
+void generateSignCorrectedMSDF(const BitmapRef<float, 3> &output, const Shape &shape, const Projection &projection, double range, const MSDFGeneratorConfig &config, FillRule fillRule) {
+    if (config.overlapSupport)
+        generateSignCorrectedDistanceField<OverlappingContourCombiner<MultiDistanceSelector> >(output, shape, projection, range, config, fillRule);
+    else
+        generateSignCorrectedDistanceField<SimpleContourCombiner<MultiDistanceSelector> >(output, shape, projection, range, config, fillRule);
+}
+
+void generateSignCorrectedMTSDF(const BitmapRef<float, 4> &output, const Shape &shape, const Projection &projection, double range, const MSDFGeneratorConfig &config, FillRule fillRule) {
+    if (config.overlapSupport)
+        generateSignCorrectedDistanceField<OverlappingContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, projection, range, config, fillRule);
+    else
+        generateSignCorrectedDistanceField<SimpleContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, projection, range, config, fillRule);
+}
+
 // Legacy API
 
 void generateSDF(const BitmapRef<float, 1> &output, const Shape &shape, double range, const Vector2 &scale, const Vector2 &translate, bool overlapSupport) {
@@ -1,97 +1,337 @@
 
 #include "rasterization.h"
 
+#include <cmath>
 #include <vector>
+#include <algorithm>
 #include "arithmetics.hpp"
+#include "ThreadPool.h"
+#include "ScanlineSweep.h"
+#include "GeneratorContext.h"
+#include "MSDFSignCorrection.h"
 
 namespace msdfgen {
 
-void rasterize(const BitmapRef<float, 1> &output, const Shape &shape, const Projection &projection, FillRule fillRule) {
-    Scanline scanline;
+void rasterize(const BitmapRef<float, 1> &output, const Shape &shape, const Projection &projection, FillRule fillRule, GeneratorContext *context) {
+    GeneratorContext localContext;
+    if (!context)
+        context = &localContext;
+    ScanlineSweep &sweep = context->scanlineSweep(shape);
+    Scanline &scanline = context->scanline();
     for (int y = 0; y < output.height; ++y) {
         int row = shape.inverseYAxis ? output.height-y-1 : y;
-        shape.scanline(scanline, projection.unprojectY(y+.5));
+        sweep.scanline(scanline, projection.unprojectY(y+.5));
         for (int x = 0; x < output.width; ++x)
             *output(x, row) = (float) scanline.filled(projection.unprojectX(x+.5), fillRule);
     }
 }
 
-void distanceSignCorrection(const BitmapRef<float, 1> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule) {
-    Scanline scanline;
-    for (int y = 0; y < sdf.height; ++y) {
-        int row = shape.inverseYAxis ? sdf.height-y-1 : y;
-        shape.scanline(scanline, projection.unprojectY(y+.5));
-        for (int x = 0; x < sdf.width; ++x) {
-            bool fill = scanline.filled(projection.unprojectX(x+.5), fillRule);
-            float &sd = *sdf(x, row);
-            if ((sd > .5f) != fill)
-                sd = 1.f-sd;
+/// Accumulates the signed area that lines cover in each pixel, as differences along each row,
+/// so that the prefix sum of a row yields the winding-weighted coverage of its pixels.
+class CoverageAccumulator {
+
+public:
+    /// Uses cells as the accumulation buffer, which must hold (width+2)*height elements.
+    CoverageAccumulator(int width, int height, float *cells) : width(width), height(height), stride(width+2), cells(cells) {
+        std::fill(cells, cells+stride*height, 0.f);
+    }
+
+    /// Adds a line in pixel coordinates. Parts left of the bitmap cover whole rows, so they are moved onto its left border.
+    void addLine(Point2 a, Point2 b) {
+        if (a.y == b.y)
+            return;
+        double t[4] = { 0, 1, 1, 1 };
+        int n = 1;
+        if ((a.x < 0) != (b.x < 0))
+            t[n++] = -a.x/(b.x-a.x);
+        if ((a.x < width) != (b.x < width))
+            t[n++] = (width-a.x)/(b.x-a.x);
+        if (n == 3 && t[1] > t[2])
+            std::swap(t[1], t[2]);
+        t[n] = 1;
+        for (int i = 0; i < n; ++i) {
+            Point2 p = mix(a, b, t[i]), q = mix(a, b, t[i+1]);
+            double xMid = .5*(p.x+q.x);
+            if (xMid >= width)
+                continue;
+            if (xMid < 0)
+                p.x = q.x = 0;
+            addInnerLine(p, q);
+        }
+    }
+
+    /// Adds a quadratic or cubic curve in pixel coordinates as a polyline.
+    void addCurve(const Point2 *p, int degree) {
+        double flatness;
+        if (degree == 2)
+            flatness = .25*(p[0]-2*p[1]+p[2]).length();
+        else
+            flatness = .75*max((p[0]-2*p[1]+p[2]).length(), (p[1]-2*p[2]+p[3]).length());
+        // The deviation of the polyline decreases quadratically with the number of its segments
+        double segmentsEstimate = ceil(sqrt(flatness/MSDFGEN_COVERAGE_FLATNESS));
+        int segments = segmentsEstimate >= 1 ? (int) min(segmentsEstimate, 1024.) : 1;
+        Point2 prev = p[0];
+        for (int i = 1; i <= segments; ++i) {
+            double t = (double) i/segments, u = 1-t;
+            Point2 cur;
+            if (degree == 2)
+                cur = u*u*p[0]+2*u*t*p[1]+t*t*p[2];
+            else
+                cur = u*u*u*p[0]+3*u*u*t*p[1]+3*u*t*t*p[2]+t*t*t*p[3];
+            if (i == segments)
+                cur = p[degree];
+            addLine(prev, cur);
+            prev = cur;
+        }
+    }
+
+    /// Computes the prefix sums of the rows and outputs the coverage according to fillRule.
+    void resolve(const BitmapRef<float, 1> &output, bool inverseYAxis, FillRule fillRule) {
+        for (int y = 0; y < height; ++y) {
+            float *row = cells+stride*y;
+            float *outputRow = output(0, inverseYAxis ? height-y-1 : y);
+            float total = 0;
+            for (int x = 0; x < width; ++x) {
+                total += row[x];
+                row[x] = total;
+            }
+            // The prefix sum is the only serial dependency, the conversion loops are vectorizable
+            switch (fillRule) {
+                case FILL_NONZERO:
+                    for (int x = 0; x < width; ++x)
+                        outputRow[x] = min(fabsf(row[x]), 1.f);
+                    break;
+                case FILL_ODD:
+                    for (int x = 0; x < width; ++x)
+                        outputRow[x] = min(fabsf(row[x]-2.f*floorf(.5f*row[x]+.5f)), 1.f);
+                    break;
+                case FILL_POSITIVE:
+                    for (int x = 0; x < width; ++x)
+                        outputRow[x] = clamp(row[x], 1.f);
+                    break;
+                case FILL_NEGATIVE:
+                    for (int x = 0; x < width; ++x)
+                        outputRow[x] = clamp(-row[x], 1.f);
+                    break;
+            }
+        }
+    }
+
+private:
+    int width, height, stride;
+    float *cells;
+
+    // Adds a line whose X coordinates are within the bitmap, distributing the area it covers in each row among the cells of the row
+    void addInnerLine(Point2 a, Point2 b) {
+        double direction = 1;
+        if (a.y > b.y) {
+            std::swap(a, b);
+            direction = -1;
+        }
+        double yStart = max(a.y, 0.), yEnd = min(b.y, (double) height);
+        if (!(yStart < yEnd))
+            return;
+        double dxdy = (b.x-a.x)/(b.y-a.y);
+        double x = a.x+dxdy*(yStart-a.y);
+        for (int y = (int) yStart; y < yEnd; ++y) {
+            double dy = min(y+1., yEnd)-max((double) y, yStart);
+            double xNext = x+dxdy*dy;
+            double d = direction*dy;
+            float *row = cells+stride*y;
+            double x0 = clamp(min(x, xNext), (double) width), x1 = clamp(max(x, xNext), (double) width);
+            int x0i = (int) floor(x0);
+            double x1Ceil = ceil(x1);
+            int x1i = (int) x1Ceil;
+            if (x1i <= x0i+1) {
+                // Within a single pixel, the area right of the line's midpoint is covered
+                double xMid = .5*(x0+x1)-x0i;
+                row[x0i] += float(d-d*xMid);
+                row[x0i+1] += float(d*xMid);
+            } else {
+                // Across several pixels, the covered area grows linearly except in the first and last pixel, where it is a triangle
+                double s = 1/(x1-x0);
+                double x0f = x0-x0i;
+                double a0 = .5*s*(1-x0f)*(1-x0f);
+                double x1f = x1-x1Ceil+1;
+                double am = .5*s*x1f*x1f;
+                row[x0i] += float(d*a0);
+                if (x1i == x0i+2)
+                    row[x0i+1] += float(d*(1-a0-am));
+                else {
+                    double a1 = s*(1.5-x0f);
+                    row[x0i+1] += float(d*(a1-a0));
+                    for (int xi = x0i+2; xi < x1i-1; ++xi)
+                        row[xi] += float(d*s);
+                    double a2 = a1+(x1i-x0i-3)*s;
+                    row[x1i-1] += float(d*(1-a2-am));
+                }
+                row[x1i] += float(d*am);
+            }
+            x = xNext;
+        }
+    }
+
+};
+
+void rasterizeCoverage(const BitmapRef<float, 1> &output, const Shape &shape, const Projection &projection, FillRule fillRule, GeneratorContext *context) {
+    GeneratorContext localContext;
+    if (!context)
+        context = &localContext;
+    CoverageAccumulator accumulator(output.width, output.height, context->coverageBuffer((output.width+2)*output.height));
+    for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour) {
+        for (std::vector<EdgeHolder>::const_iterator edge = contour->edges.begin(); edge != contour->edges.end(); ++edge) {
+            Point2 p[4];
+            if (const LinearSegment *linear = dynamic_cast<const LinearSegment *>(&**edge))
+                accumulator.addLine(projection.project(linear->p[0]), projection.project(linear->p[1]));
+            else if (const QuadraticSegment *quadratic = dynamic_cast<const QuadraticSegment *>(&**edge)) {
+                for (int i = 0; i < 3; ++i)
+                    p[i] = projection.project(quadratic->p[i]);
+                accumulator.addCurve(p, 2);
+            } else if (const CubicSegment *cubic = dynamic_cast<const CubicSegment *>(&**edge)) {
+                for (int i = 0; i < 4; ++i)
+                    p[i] = projection.project(cubic->p[i]);
+                accumulator.addCurve(p, 3);
+            } else {
+                // Segments of other types are sampled uniformly
+                Point2 prev = projection.project((*edge)->point(0));
+                for (int i = 1; i <= 64; ++i) {
+                    Point2 cur = projection.project((*edge)->point(i/64.));
+                    accumulator.addLine(prev, cur);
+                    prev = cur;
+                }
+            }
         }
     }
+    accumulator.resolve(output, shape.inverseYAxis, fillRule);
 }
 
+static int bandCount(int height) {
+    return (height+MSDFGEN_PARALLEL_BAND_HEIGHT-1)/MSDFGEN_PARALLEL_BAND_HEIGHT;
+}
+
+/// The scanline sweep and scanline of a thread working on a sign correction task. The first thread to be set up borrows those of the GeneratorContext,
+/// which is claimed through a single chunk, while any other threads use their own.
+class ThreadScanline {
+    ScanlineSweep localSweep;
+    Scanline localScanline;
+public:
+    ScanlineSweep *sweep;
+    Scanline *scanline;
+    ThreadScanline(GeneratorContext &context, ThreadPool::Chunks &contextClaim, const Shape &shape) {
+        int claim;
+        if (contextClaim.next(claim)) {
+            sweep = &context.scanlineSweep(shape);
+            scanline = &context.scanline();
+        } else {
+            localSweep.reset(shape);
+            sweep = &localSweep;
+            scanline = &localScanline;
+        }
+    }
+};
+
+class SignCorrectionTask : public ThreadPool::Task {
+    const BitmapRef<float, 1> &sdf;
+    const Shape &shape;
+    const Projection &projection;
+    FillRule fillRule;
+    GeneratorContext &context;
+    ThreadPool::Chunks contextClaim;
+public:
+    inline SignCorrectionTask(const BitmapRef<float, 1> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule, GeneratorContext &context) : sdf(sdf), shape(shape), projection(projection), fillRule(fillRule), context(context), contextClaim(1) { }
+    void work(ThreadPool::Chunks &chunks) {
+        ThreadScanline threadScanline(context, contextClaim, shape);
+        ScanlineSweep &sweep = *threadScanline.sweep;
+        Scanline &scanline = *threadScanline.scanline;
+        for (int band; chunks.next(band);) {
+            int yEnd = min((band+1)*MSDFGEN_PARALLEL_BAND_HEIGHT, sdf.height);
+            for (int y = band*MSDFGEN_PARALLEL_BAND_HEIGHT; y < yEnd; ++y) {
+                int row = shape.inverseYAxis ? sdf.height-y-1 : y;
+                sweep.scanline(scanline, projection.unprojectY(y+.5));
+                for (int x = 0; x < sdf.width; ++x) {
+                    bool fill = scanline.filled(projection.unprojectX(x+.5), fillRule);
+                    float &sd = *sdf(x, row);
+                    if ((sd > .5f) != fill)
+                        sd = 1.f-sd;
+                }
+            }
+        }
+    }
+};
+
+void distanceSignCorrection(const BitmapRef<float, 1> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule, int threadCount, GeneratorContext *context) {
+    GeneratorContext localContext;
+    SignCorrectionTask task(sdf, shape, projection, fillRule, context ? *context : localContext);
+    ThreadPool::run(task, bandCount(sdf.height), threadCount);
+}
+
+/// Corrects the signs of bands of rows of the MSDF and records whether each band contains an ambiguous texel.
 template <int N>
-static void multiDistanceSignCorrection(const BitmapRef<float, N> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule) {
+class MultiSignCorrectionTask : public ThreadPool::Task {
+    const BitmapRef<float, N> &sdf;
+    const Shape &shape;
+    const MSDFSignCorrection &signCorrection;
+    char *ambiguousBands;
+    GeneratorContext &context;
+    ThreadPool::Chunks contextClaim;
+public:
+    inline MultiSignCorrectionTask(const BitmapRef<float, N> &sdf, const Shape &shape, const MSDFSignCorrection &signCorrection, char *ambiguousBands, GeneratorContext &context) : sdf(sdf), shape(shape), signCorrection(signCorrection), ambiguousBands(ambiguousBands), context(context), contextClaim(1) { }
+    void work(ThreadPool::Chunks &chunks) {
+        ThreadScanline threadScanline(context, contextClaim, shape);
+        for (int band; chunks.next(band);) {
+            bool ambiguous = false;
+            int yEnd = min((band+1)*MSDFGEN_PARALLEL_BAND_HEIGHT, sdf.height);
+            for (int y = band*MSDFGEN_PARALLEL_BAND_HEIGHT; y < yEnd; ++y)
+                ambiguous |= signCorrection.correctRow(sdf, *threadScanline.sweep, *threadScanline.scanline, y);
+            ambiguousBands[band] = ambiguous;
+        }
+    }
+};
+
+/// Resolves the ambiguous texels of bands of rows. Only reads the match map, so bands are independent.
+template <int N>
+class AmbiguitySignCorrectionTask : public ThreadPool::Task {
+    const BitmapRef<float, N> &sdf;
+    const MSDFSignCorrection &signCorrection;
+public:
+    inline AmbiguitySignCorrectionTask(const BitmapRef<float, N> &sdf, const MSDFSignCorrection &signCorrection) : sdf(sdf), signCorrection(signCorrection) { }
+    void work(ThreadPool::Chunks &chunks) {
+        for (int band; chunks.next(band);) {
+            int yEnd = min((band+1)*MSDFGEN_PARALLEL_BAND_HEIGHT, sdf.height);
+            for (int y = band*MSDFGEN_PARALLEL_BAND_HEIGHT; y < yEnd; ++y)
+                signCorrection.resolveRow(sdf, y);
+        }
+    }
+};
+
+template <int N>
+static void multiDistanceSignCorrection(const BitmapRef<float, N> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule, int threadCount, GeneratorContext *context) {
     int w = sdf.width, h = sdf.height;
     if (!(w*h))
         return;
-    Scanline scanline;
-    bool ambiguous = false;
-    std::vector<char> matchMap;
-    matchMap.resize(w*h);
-    char *match = &matchMap[0];
-    for (int y = 0; y < h; ++y) {
-        int row = shape.inverseYAxis ? h-y-1 : y;
-        shape.scanline(scanline, projection.unprojectY(y+.5));
-        for (int x = 0; x < w; ++x) {
-            bool fill = scanline.filled(projection.unprojectX(x+.5), fillRule);
-            float *msd = sdf(x, row);
-            float sd = median(msd[0], msd[1], msd[2]);
-            if (sd == .5f)
-                ambiguous = true;
-            else if ((sd > .5f) != fill) {
-                msd[0] = 1.f-msd[0];
-                msd[1] = 1.f-msd[1];
-                msd[2] = 1.f-msd[2];
-                *match = -1;
-            } else
-                *match = 1;
-            if (N >= 4 && (msd[3] > .5f) != fill)
-                msd[3] = 1.f-msd[3];
-            ++match;
-        }
+    GeneratorContext localContext;
+    if (!context)
+        context = &localContext;
+    int bands = bandCount(h);
+    char *ambiguousBands = context->bandBuffer(bands);
+    MSDFSignCorrection signCorrection(context->matchMapBuffer(w*h), shape, projection, fillRule);
+    {
+        MultiSignCorrectionTask<N> task(sdf, shape, signCorrection, ambiguousBands, *context);
+        ThreadPool::run(task, bands, threadCount);
     }
     // This step is necessary to avoid artifacts when whole shape is inverted
-    if (ambiguous) {
-        match = &matchMap[0];
-        for (int y = 0; y < h; ++y) {
-            int row = shape.inverseYAxis ? h-y-1 : y;
-            for (int x = 0; x < w; ++x) {
-                if (!*match) {
-                    int neighborMatch = 0;
-                    if (x > 0) neighborMatch += *(match-1);
-                    if (x < w-1) neighborMatch += *(match+1);
-                    if (y > 0) neighborMatch += *(match-w);
-                    if (y < h-1) neighborMatch += *(match+w);
-                    if (neighborMatch < 0) {
-                        float *msd = sdf(x, row);
-                        msd[0] = 1.f-msd[0];
-                        msd[1] = 1.f-msd[1];
-                        msd[2] = 1.f-msd[2];
-                    }
-                }
-                ++match;
-            }
-        }
+    if (std::find(ambiguousBands, ambiguousBands+bands, true) != ambiguousBands+bands) {
+        AmbiguitySignCorrectionTask<N> task(sdf, signCorrection);
+        ThreadPool::run(task, bands, threadCount);
     }
 }
 
-void distanceSignCorrection(const BitmapRef<float, 3> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule) {
-    multiDistanceSignCorrection(sdf, shape, projection, fillRule);
+void distanceSignCorrection(const BitmapRef<float, 3> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule, int threadCount, GeneratorContext *context) {
+    multiDistanceSignCorrection(sdf, shape, projection, fillRule, threadCount, context);
 }
 
-void distanceSignCorrection(const BitmapRef<float, 4> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule) {
-    multiDistanceSignCorrection(sdf, shape, projection, fillRule);
+void distanceSignCorrection(const BitmapRef<float, 4> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule, int threadCount, GeneratorContext *context) {
+    multiDistanceSignCorrection(sdf, shape, projection, fillRule, threadCount, context);
 }
 
 // Legacy API
@@ -6,15 +6,25 @@
 #include "Projection.h"
 #include "Scanline.h"
 #include "BitmapRef.hpp"
+#include "GeneratorContext.h"
+
+// The maximum distance in pixels between a curve and the polyline it is approximated by in coverage rasterization.
+#ifndef MSDFGEN_COVERAGE_FLATNESS
+#define MSDFGEN_COVERAGE_FLATNESS .01
+#endif
 
 namespace msdfgen {
 
-/// Rasterizes the shape into a monochrome bitmap.
-void rasterize(const BitmapRef<float, 1> &output, const Shape &shape, const Projection &projection, FillRule fillRule = FILL_NONZERO);
+/// Rasterizes the shape into a monochrome bitmap. The temporary memory of this and the following functions is taken from context if provided.
+void rasterize(const BitmapRef<float, 1> &output, const Shape &shape, const Projection &projection, FillRule fillRule = FILL_NONZERO, GeneratorContext *context = NULL);
+/// Rasterizes the shape into an anti-aliased bitmap of the exact fraction of each pixel's area covered by the shape, with curves flattened to MSDFGEN_COVERAGE_FLATNESS.
+/// The coverage is accumulated from the signed areas of the edges, so where contours overlap within a pixel, rules other than non-zero are approximated.
+void rasterizeCoverage(const BitmapRef<float, 1> &output, const Shape &shape, const Projection &projection, FillRule fillRule = FILL_NONZERO, GeneratorContext *context = NULL);
 /// Fixes the sign of the input signed distance field, so that it matches the shape's rasterized fill.
-void distanceSignCorrection(const BitmapRef<float, 1> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule = FILL_NONZERO);
-void distanceSignCorrection(const BitmapRef<float, 3> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule = FILL_NONZERO);
-void distanceSignCorrection(const BitmapRef<float, 4> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule = FILL_NONZERO);
+/// The bitmap is processed in bands of rows by up to threadCount threads (0 = one per CPU core).
+void distanceSignCorrection(const BitmapRef<float, 1> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule = FILL_NONZERO, int threadCount = 1, GeneratorContext *context = NULL);
+void distanceSignCorrection(const BitmapRef<float, 3> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule = FILL_NONZERO, int threadCount = 1, GeneratorContext *context = NULL);
+void distanceSignCorrection(const BitmapRef<float, 4> &sdf, const Shape &shape, const Projection &projection, FillRule fillRule = FILL_NONZERO, int threadCount = 1, GeneratorContext *context = NULL);
 
 // Old version of the function API's kept for backwards compatibility
 void rasterize(const BitmapRef<float, 1> &output, const Shape &shape, const Vector2 &scale, const Vector2 &translate, FillRule fillRule = FILL_NONZERO);
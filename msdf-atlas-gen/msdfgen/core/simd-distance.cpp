@@ -0,0 +1,485 @@
+
+#include "simd-distance.h"
+
+#include "arithmetics.hpp"
+#include "edge-segment-kernels.hpp"
+
+#if !defined(MSDFGEN_NO_SIMD) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+    #define MSDFGEN_SIMD_AVX2
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define MSDFGEN_AVX2_FUNCTION
+    #else
+        #define MSDFGEN_AVX2_FUNCTION __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace msdfgen {
+
+#ifdef MSDFGEN_SIMD_AVX2
+
+#define PI 3.14159265358979323846
+
+// Taylor series coefficients of (asin(x)-x)/x^3 in powers of x^2
+static const double ASIN_COEFFICIENTS[] = {
+    0.16666666666666666,
+    0.075,
+    0.044642857142857144,
+    0.030381944444444444,
+    0.022372159090909092,
+    0.017352764423076924,
+    0.01396484375,
+    0.011551800896139705,
+    0.009761609529194078,
+    0.008390335809616815,
+    0.0073125258735988454,
+    0.006447210311889649,
+    0.005740037670841924,
+    0.005153309682319905,
+    0.004660143486915096,
+    0.004240907093679363,
+    0.003880964558837669,
+    0.0035692053938259347,
+    0.003297059503473485,
+    0.0030578216492580306,
+    0.002846178401108942,
+    0.00265787063820729
+};
+
+// Taylor series coefficients of cos(x) in powers of x^2
+static const double COS_COEFFICIENTS[] = {
+    1.0,
+    -0.5,
+    0.041666666666666664,
+    -0.001388888888888889,
+    2.48015873015873e-05,
+    -2.755731922398589e-07,
+    2.08767569878681e-09,
+    -1.1470745597729725e-11,
+    4.779477332387385e-14,
+    -1.5619206968586225e-16,
+    4.110317623312165e-19,
+    -8.896791392450574e-22
+};
+
+typedef __m256d Lanes;
+
+struct LaneVector {
+    Lanes x, y;
+};
+
+// The helpers below perform the same operations in the same order as their scalar counterparts (Vector2, arithmetics.hpp)
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes broadcast(double value) {
+    return _mm256_set1_pd(value);
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes add(Lanes a, Lanes b) {
+    return _mm256_add_pd(a, b);
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes sub(Lanes a, Lanes b) {
+    return _mm256_sub_pd(a, b);
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes mul(Lanes a, Lanes b) {
+    return _mm256_mul_pd(a, b);
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes div(Lanes a, Lanes b) {
+    return _mm256_div_pd(a, b);
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes negate(Lanes a) {
+    return _mm256_xor_pd(a, _mm256_set1_pd(-0.));
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes absolute(Lanes a) {
+    return _mm256_andnot_pd(_mm256_set1_pd(-0.), a);
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes both(Lanes a, Lanes b) {
+    return _mm256_and_pd(a, b);
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes either(Lanes a, Lanes b) {
+    return _mm256_or_pd(a, b);
+}
+
+/// Returns a where mask is set and b elsewhere.
+MSDFGEN_AVX2_FUNCTION static inline Lanes select(Lanes mask, Lanes a, Lanes b) {
+    return _mm256_blendv_pd(b, a, mask);
+}
+
+MSDFGEN_AVX2_FUNCTION static inline bool any(Lanes mask) {
+    return _mm256_movemask_pd(mask) != 0;
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes nonZeroSign(Lanes n) {
+    return select(_mm256_cmp_pd(n, _mm256_setzero_pd(), _CMP_GT_OQ), broadcast(1), broadcast(-1));
+}
+
+MSDFGEN_AVX2_FUNCTION static inline LaneVector laneVector(Lanes x, Lanes y) {
+    LaneVector v;
+    v.x = x, v.y = y;
+    return v;
+}
+
+MSDFGEN_AVX2_FUNCTION static inline LaneVector sub(const Vector2 &a, const LaneVector &b) {
+    return laneVector(sub(broadcast(a.x), b.x), sub(broadcast(a.y), b.y));
+}
+
+MSDFGEN_AVX2_FUNCTION static inline LaneVector sub(const LaneVector &a, const Vector2 &b) {
+    return laneVector(sub(a.x, broadcast(b.x)), sub(a.y, broadcast(b.y)));
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes dotProduct(const LaneVector &a, const LaneVector &b) {
+    return add(mul(a.x, b.x), mul(a.y, b.y));
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes dotProduct(const LaneVector &a, const Vector2 &b) {
+    return add(mul(a.x, broadcast(b.x)), mul(a.y, broadcast(b.y)));
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes dotProduct(const Vector2 &a, const LaneVector &b) {
+    return add(mul(broadcast(a.x), b.x), mul(broadcast(a.y), b.y));
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes crossProduct(const LaneVector &a, const LaneVector &b) {
+    return sub(mul(a.x, b.y), mul(a.y, b.x));
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes crossProduct(const LaneVector &a, const Vector2 &b) {
+    return sub(mul(a.x, broadcast(b.y)), mul(a.y, broadcast(b.x)));
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes crossProduct(const Vector2 &a, const LaneVector &b) {
+    return sub(mul(broadcast(a.x), b.y), mul(broadcast(a.y), b.x));
+}
+
+MSDFGEN_AVX2_FUNCTION static inline Lanes length(const LaneVector &v) {
+    return _mm256_sqrt_pd(add(mul(v.x, v.x), mul(v.y, v.y)));
+}
+
+/// Same as Vector2::normalize(false).
+MSDFGEN_AVX2_FUNCTION static inline LaneVector normalize(const LaneVector &v) {
+    Lanes len = length(v);
+    Lanes zero = _mm256_cmp_pd(len, _mm256_setzero_pd(), _CMP_EQ_OQ);
+    return laneVector(select(zero, _mm256_setzero_pd(), div(v.x, len)), select(zero, broadcast(1), div(v.y, len)));
+}
+
+MSDFGEN_AVX2_FUNCTION static inline LaneVector loadOrigins(const double *x, const double *y) {
+    return laneVector(_mm256_loadu_pd(x), _mm256_loadu_pd(y));
+}
+
+MSDFGEN_AVX2_FUNCTION static inline void storeDistances(SignedDistance *distances, double *params, Lanes distance, Lanes dot, Lanes param) {
+    double d[MSDFGEN_SIMD_LANES], a[MSDFGEN_SIMD_LANES];
+    _mm256_storeu_pd(d, distance);
+    _mm256_storeu_pd(a, dot);
+    _mm256_storeu_pd(params, param);
+    for (int i = 0; i < MSDFGEN_SIMD_LANES; ++i)
+        distances[i] = SignedDistance(d[i], a[i]);
+}
+
+/// Arc cosine of values between -1 and 1.
+MSDFGEN_AVX2_FUNCTION static inline Lanes acosApprox(Lanes t) {
+    // acos(x) = pi/2-asin(x) for |x| <= 1/2, acos(x) = 2*asin(sqrt((1-x)/2)) above, acos(-x) = pi-acos(x)
+    Lanes x = absolute(t);
+    Lanes small = _mm256_cmp_pd(x, broadcast(.5), _CMP_LE_OQ);
+    Lanes s = select(small, x, _mm256_sqrt_pd(mul(broadcast(.5), sub(broadcast(1), x))));
+    Lanes z = mul(s, s);
+    const int n = sizeof(ASIN_COEFFICIENTS)/sizeof(*ASIN_COEFFICIENTS);
+    Lanes poly = broadcast(ASIN_COEFFICIENTS[n-1]);
+    for (int i = n-2; i >= 0; --i)
+        poly = add(mul(poly, z), broadcast(ASIN_COEFFICIENTS[i]));
+    Lanes asinS = add(s, mul(mul(s, z), poly));
+    Lanes negative = _mm256_cmp_pd(t, _mm256_setzero_pd(), _CMP_LT_OQ);
+    Lanes smallResult = select(negative, add(broadcast(.5*PI), asinS), sub(broadcast(.5*PI), asinS));
+    Lanes largeResult = select(negative, sub(broadcast(PI), add(asinS, asinS)), add(asinS, asinS));
+    return select(small, smallResult, largeResult);
+}
+
+/// Cosine of values between -pi and pi.
+MSDFGEN_AVX2_FUNCTION static inline Lanes cosApprox(Lanes angle) {
+    // cos(x) = -cos(pi-x) reduces the argument to [0, pi/2]
+    Lanes x = absolute(angle);
+    Lanes flip = _mm256_cmp_pd(x, broadcast(.5*PI), _CMP_GT_OQ);
+    x = select(flip, sub(broadcast(PI), x), x);
+    Lanes z = mul(x, x);
+    const int n = sizeof(COS_COEFFICIENTS)/sizeof(*COS_COEFFICIENTS);
+    Lanes poly = broadcast(COS_COEFFICIENTS[n-1]);
+    for (int i = n-2; i >= 0; --i)
+        poly = add(mul(poly, z), broadcast(COS_COEFFICIENTS[i]));
+    return select(flip, negate(poly), poly);
+}
+
+/// Cube root of non-negative values.
+MSDFGEN_AVX2_FUNCTION static inline Lanes cbrtApprox(Lanes w) {
+    // Initial estimate by dividing the exponent of the single precision value by three, refined by Newton's method
+    __m128i bits = _mm_castps_si128(_mm256_cvtpd_ps(w));
+    bits = _mm_add_epi32(_mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(bits), _mm_set1_ps(1/3.f))), _mm_set1_epi32(709958130));
+    Lanes y = _mm256_cvtps_pd(_mm_castsi128_ps(bits));
+    for (int i = 0; i < 4; ++i) {
+        Lanes yy = mul(y, y);
+        y = sub(y, div(sub(mul(yy, y), w), mul(broadcast(3), yy)));
+    }
+    // Zero and values out of the single precision range are left to the standard library
+    Lanes regular = both(_mm256_cmp_pd(w, broadcast(1e-30), _CMP_GE_OQ), _mm256_cmp_pd(w, broadcast(1e30), _CMP_LE_OQ));
+    if (_mm256_movemask_pd(regular) != 0xf) {
+        double wValues[MSDFGEN_SIMD_LANES], yValues[MSDFGEN_SIMD_LANES];
+        _mm256_storeu_pd(wValues, w);
+        _mm256_storeu_pd(yValues, y);
+        int regularMask = _mm256_movemask_pd(regular);
+        for (int i = 0; i < MSDFGEN_SIMD_LANES; ++i) {
+            if (!(regularMask&1<<i))
+                yValues[i] = pow(wValues[i], 1/3.);
+        }
+        y = _mm256_loadu_pd(yValues);
+    }
+    return y;
+}
+
+/// Vectorized solveCubicNormed of equation-solver.cpp. Root i is only valid in lanes where valid[i] is set.
+MSDFGEN_AVX2_FUNCTION static void solveCubicNormed(Lanes x[3], Lanes valid[3], double a, Lanes b, Lanes c) {
+    double a2 = a*a;
+    Lanes q = mul(broadcast(1/9.), sub(broadcast(a2), mul(broadcast(3), b)));
+    Lanes r = mul(broadcast(1/54.), add(mul(broadcast(a), sub(broadcast(2*a2), mul(broadcast(9), b))), mul(broadcast(27), c)));
+    Lanes r2 = mul(r, r);
+    Lanes q3 = mul(mul(q, q), q);
+    Lanes aThird = broadcast(a*(1/3.));
+    Lanes threeRoots = _mm256_cmp_pd(r2, q3, _CMP_LT_OQ);
+
+    // Three real roots
+    Lanes t = div(r, _mm256_sqrt_pd(q3));
+    t = select(_mm256_cmp_pd(t, broadcast(-1), _CMP_LT_OQ), broadcast(-1), t);
+    t = select(_mm256_cmp_pd(t, broadcast(1), _CMP_GT_OQ), broadcast(1), t);
+    t = acosApprox(t);
+    Lanes qs = mul(broadcast(-2), _mm256_sqrt_pd(q));
+    Lanes x0 = sub(mul(qs, cosApprox(mul(broadcast(1/3.), t))), aThird);
+    Lanes x1 = sub(mul(qs, cosApprox(mul(broadcast(1/3.), add(t, broadcast(2*PI))))), aThird);
+    Lanes x2 = sub(mul(qs, cosApprox(mul(broadcast(1/3.), sub(t, broadcast(2*PI))))), aThird);
+
+    // One or two real roots
+    Lanes sign = select(_mm256_cmp_pd(r, _mm256_setzero_pd(), _CMP_LT_OQ), broadcast(1), broadcast(-1));
+    Lanes u = mul(sign, cbrtApprox(add(absolute(r), _mm256_sqrt_pd(sub(r2, q3)))));
+    Lanes v = select(_mm256_cmp_pd(u, _mm256_setzero_pd(), _CMP_EQ_OQ), _mm256_setzero_pd(), div(q, u));
+    Lanes y0 = sub(add(u, v), aThird);
+    Lanes y1 = sub(mul(broadcast(-.5), add(u, v)), aThird);
+    Lanes twoRoots = either(_mm256_cmp_pd(u, v, _CMP_EQ_OQ), _mm256_cmp_pd(absolute(sub(u, v)), mul(broadcast(1e-12), absolute(add(u, v))), _CMP_LT_OQ));
+
+    x[0] = select(threeRoots, x0, y0);
+    x[1] = select(threeRoots, x1, y1);
+    x[2] = x2;
+    valid[0] = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    valid[1] = either(threeRoots, twoRoots);
+    valid[2] = threeRoots;
+}
+
+/// Returns the dot component of a signed distance whose closest point lies beyond an endpoint, depending on param.
+MSDFGEN_AVX2_FUNCTION static inline Lanes endpointDot(Lanes param, const Vector2 &aDir, const LaneVector &qa, const Vector2 &bDir, const LaneVector &qb) {
+    Lanes inside = both(_mm256_cmp_pd(param, _mm256_setzero_pd(), _CMP_GE_OQ), _mm256_cmp_pd(param, broadcast(1), _CMP_LE_OQ));
+    Lanes aDot = absolute(dotProduct(aDir.normalize(), normalize(qa)));
+    Lanes bDot = absolute(dotProduct(bDir.normalize(), normalize(qb)));
+    return select(inside, _mm256_setzero_pd(), select(_mm256_cmp_pd(param, broadcast(.5), _CMP_LT_OQ), aDot, bDot));
+}
+
+MSDFGEN_AVX2_FUNCTION static void linearSignedDistancesAVX2(const Point2 *p, const double *x, const double *y, SignedDistance *distances, double *params) {
+    LaneVector origin = loadOrigins(x, y);
+    Vector2 ab = p[1]-p[0];
+    LaneVector aq = sub(origin, p[0]);
+    Lanes param = div(dotProduct(aq, ab), broadcast(dotProduct(ab, ab)));
+    Lanes towardB = _mm256_cmp_pd(param, broadcast(.5), _CMP_GT_OQ);
+    LaneVector eq = laneVector(sub(select(towardB, broadcast(p[1].x), broadcast(p[0].x)), origin.x), sub(select(towardB, broadcast(p[1].y), broadcast(p[0].y)), origin.y));
+    Lanes endpointDistance = length(eq);
+    Lanes orthoDistance = dotProduct(ab.getOrthonormal(false), aq);
+    Lanes ortho = both(
+        both(_mm256_cmp_pd(param, _mm256_setzero_pd(), _CMP_GT_OQ), _mm256_cmp_pd(param, broadcast(1), _CMP_LT_OQ)),
+        _mm256_cmp_pd(absolute(orthoDistance), endpointDistance, _CMP_LT_OQ)
+    );
+    Lanes distance = select(ortho, orthoDistance, mul(nonZeroSign(crossProduct(aq, ab)), endpointDistance));
+    Lanes dot = select(ortho, _mm256_setzero_pd(), absolute(dotProduct(ab.normalize(), normalize(eq))));
+    storeDistances(distances, params, distance, dot, param);
+}
+
+MSDFGEN_AVX2_FUNCTION static void quadraticSignedDistancesAVX2(const Point2 *p, const double *x, const double *y, SignedDistance *distances, double *params) {
+    Vector2 ab = p[1]-p[0];
+    Vector2 br = p[2]-p[1]-ab;
+    double a = dotProduct(br, br);
+    double b = 3*dotProduct(ab, br);
+    // Whether solveCubic normalizes the equation only depends on the segment, otherwise it degenerates to a quadratic equation
+    if (!(a != 0 && fabs(b/a) < 1e6)) {
+        for (int i = 0; i < MSDFGEN_SIMD_LANES; ++i)
+            distances[i] = quadraticSignedDistance(p, Point2(x[i], y[i]), params[i]);
+        return;
+    }
+
+    LaneVector origin = loadOrigins(x, y);
+    LaneVector qa = sub(p[0], origin);
+    Lanes c = add(broadcast(2*dotProduct(ab, ab)), dotProduct(qa, br));
+    Lanes d = dotProduct(qa, ab);
+    Lanes t[3], valid[3];
+    solveCubicNormed(t, valid, b/a, div(c, broadcast(a)), div(d, broadcast(a)));
+
+    Vector2 aDir = quadraticDirection(p, 0);
+    Vector2 bDir = quadraticDirection(p, 1);
+    Lanes minDistance = mul(nonZeroSign(crossProduct(aDir, qa)), length(qa)); // distance from A
+    Lanes param = div(negate(dotProduct(qa, aDir)), broadcast(dotProduct(aDir, aDir)));
+    LaneVector qb = sub(p[2], origin);
+    {
+        Lanes distance = length(qb); // distance from B
+        Lanes closer = _mm256_cmp_pd(distance, absolute(minDistance), _CMP_LT_OQ);
+        minDistance = select(closer, mul(nonZeroSign(crossProduct(bDir, qb)), distance), minDistance);
+        param = select(closer, div(dotProduct(sub(origin, p[1]), bDir), broadcast(dotProduct(bDir, bDir))), param);
+    }
+    for (int i = 0; i < 3; ++i) {
+        Lanes inside = both(valid[i], both(_mm256_cmp_pd(t[i], _mm256_setzero_pd(), _CMP_GT_OQ), _mm256_cmp_pd(t[i], broadcast(1), _CMP_LT_OQ)));
+        if (!any(inside))
+            continue;
+        Lanes t2 = mul(broadcast(2), t[i]);
+        Lanes tt = mul(t[i], t[i]);
+        LaneVector qe = laneVector(
+            add(add(qa.x, mul(t2, broadcast(ab.x))), mul(tt, broadcast(br.x))),
+            add(add(qa.y, mul(t2, broadcast(ab.y))), mul(tt, broadcast(br.y)))
+        );
+        Lanes distance = length(qe);
+        Lanes closer = both(inside, _mm256_cmp_pd(distance, absolute(minDistance), _CMP_LE_OQ));
+        LaneVector dir = laneVector(add(broadcast(ab.x), mul(t[i], broadcast(br.x))), add(broadcast(ab.y), mul(t[i], broadcast(br.y))));
+        minDistance = select(closer, mul(nonZeroSign(crossProduct(dir, qe)), distance), minDistance);
+        param = select(closer, t[i], param);
+    }
+
+    storeDistances(distances, params, minDistance, endpointDot(param, aDir, qa, bDir, qb), param);
+}
+
+MSDFGEN_AVX2_FUNCTION static void cubicSignedDistancesAVX2(const Point2 *p, const CubicCoefficients<Vector2> &c, const double *x, const double *y, SignedDistance *distances, double *params) {
+    LaneVector origin = loadOrigins(x, y);
+    LaneVector qa = sub(p[0], origin);
+    const Vector2 &ab = c.ab, &br = c.br, &as = c.as;
+
+    const Vector2 &aDir = c.aDir;
+    const Vector2 &bDir = c.bDir;
+    Lanes minDistance = mul(nonZeroSign(crossProduct(aDir, qa)), length(qa)); // distance from A
+    Lanes param = div(negate(dotProduct(qa, aDir)), broadcast(dotProduct(aDir, aDir)));
+    LaneVector qb = sub(p[3], origin);
+    Lanes nearB;
+    {
+        Lanes distance = length(qb); // distance from B
+        nearB = _mm256_cmp_pd(distance, absolute(minDistance), _CMP_LT_OQ);
+        minDistance = select(nearB, mul(nonZeroSign(crossProduct(bDir, qb)), distance), minDistance);
+        LaneVector bDirQb = sub(bDir, qb);
+        param = select(nearB, div(dotProduct(bDirQb, bDir), broadcast(dotProduct(bDir, bDir))), param);
+    }
+    // Lanes whose nearest endpoint has all control points beyond it are not searched, see cubicSignedDistance
+    Lanes zero = _mm256_setzero_pd();
+    Lanes aHullBeyond = both(both(
+        _mm256_cmp_pd(dotProduct(p[1]-p[0], qa), zero, _CMP_GE_OQ),
+        _mm256_cmp_pd(dotProduct(p[2]-p[0], qa), zero, _CMP_GE_OQ)),
+        _mm256_cmp_pd(dotProduct(p[3]-p[0], qa), zero, _CMP_GE_OQ)
+    );
+    Lanes bHullBeyond = both(both(
+        _mm256_cmp_pd(dotProduct(p[0]-p[3], qb), zero, _CMP_GE_OQ),
+        _mm256_cmp_pd(dotProduct(p[1]-p[3], qb), zero, _CMP_GE_OQ)),
+        _mm256_cmp_pd(dotProduct(p[2]-p[3], qb), zero, _CMP_GE_OQ)
+    );
+    Lanes searched = _mm256_andnot_pd(select(nearB, bHullBeyond, aHullBeyond), _mm256_castsi256_pd(_mm256_set1_epi64x(-1)));
+    // Iterative minimum distance search
+    Vector2 ab3 = 3*ab, br6 = 6*br;
+    for (int i = 0; any(searched) && i <= c.searchStarts; ++i) {
+        double t0 = (double) i/c.searchStarts;
+        LaneVector qe = laneVector(
+            add(add(add(qa.x, broadcast(3*t0*ab.x)), broadcast(3*t0*t0*br.x)), broadcast(t0*t0*t0*as.x)),
+            add(add(add(qa.y, broadcast(3*t0*ab.y)), broadcast(3*t0*t0*br.y)), broadcast(t0*t0*t0*as.y))
+        );
+        Lanes t = broadcast(t0);
+        Lanes active = searched;
+        for (int step = 0; step < MSDFGEN_CUBIC_SEARCH_STEPS; ++step) {
+            // Improve t
+            Lanes t3 = mul(broadcast(3), t);
+            Lanes t6 = mul(broadcast(6), t);
+            Lanes t3t = mul(t3, t);
+            LaneVector d1 = laneVector(
+                add(add(broadcast(ab3.x), mul(t6, broadcast(br.x))), mul(t3t, broadcast(as.x))),
+                add(add(broadcast(ab3.y), mul(t6, broadcast(br.y))), mul(t3t, broadcast(as.y)))
+            );
+            LaneVector d2 = laneVector(add(broadcast(br6.x), mul(t6, broadcast(as.x))), add(broadcast(br6.y), mul(t6, broadcast(as.y))));
+            t = select(active, sub(t, div(dotProduct(qe, d1), add(dotProduct(d1, d1), dotProduct(qe, d2)))), t);
+            active = _mm256_andnot_pd(either(_mm256_cmp_pd(t, _mm256_setzero_pd(), _CMP_LE_OQ), _mm256_cmp_pd(t, broadcast(1), _CMP_GE_OQ)), active);
+            if (!any(active))
+                break;
+            t3 = mul(broadcast(3), t);
+            t3t = mul(t3, t);
+            Lanes ttt = mul(mul(t, t), t);
+            qe = laneVector(
+                add(add(add(qa.x, mul(t3, broadcast(ab.x))), mul(t3t, broadcast(br.x))), mul(ttt, broadcast(as.x))),
+                add(add(add(qa.y, mul(t3, broadcast(ab.y))), mul(t3t, broadcast(br.y))), mul(ttt, broadcast(as.y)))
+            );
+            Lanes distance = length(qe);
+            Lanes closer = both(active, _mm256_cmp_pd(distance, absolute(minDistance), _CMP_LT_OQ));
+            minDistance = select(closer, mul(nonZeroSign(crossProduct(d1, qe)), distance), minDistance);
+            param = select(closer, t, param);
+        }
+    }
+
+    storeDistances(distances, params, minDistance, endpointDot(param, aDir, qa, bDir, qb), param);
+}
+
+static bool detectAVX2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    // OSXSAVE and AVX, and the operating system saves the YMM registers
+    if (!(info[2]&1<<27) || !(info[2]&1<<28) || (_xgetbv(0)&6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1]&1<<5) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+bool simdDistanceSupported() {
+    static const bool supported = detectAVX2();
+    return supported;
+}
+
+void linearSignedDistances(const Point2 *p, const double *x, const double *y, SignedDistance *distances, double *params) {
+    linearSignedDistancesAVX2(p, x, y, distances, params);
+}
+
+void quadraticSignedDistances(const Point2 *p, const double *x, const double *y, SignedDistance *distances, double *params) {
+    quadraticSignedDistancesAVX2(p, x, y, distances, params);
+}
+
+void cubicSignedDistances(const Point2 *p, const CubicCoefficients<Vector2> &coefficients, const double *x, const double *y, SignedDistance *distances, double *params) {
+    cubicSignedDistancesAVX2(p, coefficients, x, y, distances, params);
+}
+
+#else
+
+bool simdDistanceSupported() {
+    return false;
+}
+
+void linearSignedDistances(const Point2 *p, const double *x, const double *y, SignedDistance *distances, double *params) {
+    for (int i = 0; i < MSDFGEN_SIMD_LANES; ++i)
+        distances[i] = linearSignedDistance(p, Point2(x[i], y[i]), params[i]);
+}
+
+void quadraticSignedDistances(const Point2 *p, const double *x, const double *y, SignedDistance *distances, double *params) {
+    for (int i = 0; i < MSDFGEN_SIMD_LANES; ++i)
+        distances[i] = quadraticSignedDistance(p, Point2(x[i], y[i]), params[i]);
+}
+
+void cubicSignedDistances(const Point2 *p, const CubicCoefficients<Vector2> &coefficients, const double *x, const double *y, SignedDistance *distances, double *params) {
+    for (int i = 0; i < MSDFGEN_SIMD_LANES; ++i)
+        distances[i] = cubicSignedDistance(p, coefficients, Point2(x[i], y[i]), params[i]);
+}
+
+#endif
+
+}
@@ -0,0 +1,25 @@
+
+#pragma once
+
+#include "Vector2.h"
+#include "SignedDistance.h"
+#include "edge-segment-kernels.hpp"
+
+namespace msdfgen {
+
+// Number of points whose distances to an edge segment are computed at once by the vectorized kernels.
+#define MSDFGEN_SIMD_LANES 4
+
+/// Returns true if the vectorized distance kernels are compiled in and supported by the CPU (requires AVX2).
+bool simdDistanceSupported();
+
+/// Vectorized versions of the signed distance kernels of edge-segment-kernels.hpp, which compute the distances of MSDFGEN_SIMD_LANES points,
+/// given by their x and y coordinates, to an edge segment given by its control points (and precomputed coefficients for cubic segments). May only be called if simdDistanceSupported returns true.
+/// Linear and cubic segments produce the exact same results as the scalar kernels. For quadratic segments, the cubic equation is solved using
+/// polynomial approximations of acos and cos (absolute error below 1e-15) and a Newton iteration for the cube root instead of the standard library,
+/// so the distances may differ from the scalar ones in the last few bits.
+void linearSignedDistances(const Point2 *p, const double *x, const double *y, SignedDistance *distances, double *params);
+void quadraticSignedDistances(const Point2 *p, const double *x, const double *y, SignedDistance *distances, double *params);
+void cubicSignedDistances(const Point2 *p, const CubicCoefficients<Vector2> &coefficients, const double *x, const double *y, SignedDistance *distances, double *params);
+
+}
@@ -30,8 +30,8 @@ class FontHandle {
     friend bool getFontMetrics(FontMetrics &metrics, FontHandle *font);
     friend bool getFontWhitespaceWidth(double &spaceAdvance, double &tabAdvance, FontHandle *font);
     friend bool getGlyphIndex(GlyphIndex &glyphIndex, FontHandle *font, unicode_t unicode);
-    friend bool loadGlyph(Shape &output, FontHandle *font, GlyphIndex glyphIndex, double *advance);
-    friend bool loadGlyph(Shape &output, FontHandle *font, unicode_t unicode, double *advance);
+    friend bool loadGlyph(Shape &output, FontHandle *font, GlyphIndex glyphIndex, double *advance, EdgeArena *edgeArena);
+    friend bool loadGlyph(Shape &output, FontHandle *font, unicode_t unicode, double *advance, EdgeArena *edgeArena);
     friend bool getKerning(double &output, FontHandle *font, GlyphIndex glyphIndex1, GlyphIndex glyphIndex2);
     friend bool getKerning(double &output, FontHandle *font, unicode_t unicode1, unicode_t unicode2);
 
@@ -44,6 +44,7 @@ struct FtContext {
     Point2 position;
     Shape *shape;
     Contour *contour;
+    EdgeArena *edgeArena;
 };
 
 static Point2 ftPoint2(const FT_Vector &vector) {
@@ -62,7 +63,10 @@ static int ftLineTo(const FT_Vector *to, void *user) {
     FtContext *context = reinterpret_cast<FtContext *>(user);
     Point2 endpoint = ftPoint2(*to);
     if (endpoint != context->position) {
-        context->contour->addEdge(new LinearSegment(context->position, endpoint));
+        if (context->edgeArena)
+            context->edgeArena->addEdge(*context->contour, context->position, endpoint);
+        else
+            context->contour->addEdge(new LinearSegment(context->position, endpoint));
         context->position = endpoint;
     }
     return 0;
@@ -70,14 +74,20 @@ static int ftLineTo(const FT_Vector *to, void *user) {
 
 static int ftConicTo(const FT_Vector *control, const FT_Vector *to, void *user) {
     FtContext *context = reinterpret_cast<FtContext *>(user);
-    context->contour->addEdge(new QuadraticSegment(context->position, ftPoint2(*control), ftPoint2(*to)));
+    if (context->edgeArena)
+        context->edgeArena->addEdge(*context->contour, context->position, ftPoint2(*control), ftPoint2(*to));
+    else
+        context->contour->addEdge(new QuadraticSegment(context->position, ftPoint2(*control), ftPoint2(*to)));
     context->position = ftPoint2(*to);
     return 0;
 }
 
 static int ftCubicTo(const FT_Vector *control1, const FT_Vector *control2, const FT_Vector *to, void *user) {
     FtContext *context = reinterpret_cast<FtContext *>(user);
-    context->contour->addEdge(new CubicSegment(context->position, ftPoint2(*control1), ftPoint2(*control2), ftPoint2(*to)));
+    if (context->edgeArena)
+        context->edgeArena->addEdge(*context->contour, context->position, ftPoint2(*control1), ftPoint2(*control2), ftPoint2(*to));
+    else
+        context->contour->addEdge(new CubicSegment(context->position, ftPoint2(*control1), ftPoint2(*control2), ftPoint2(*to)));
     context->position = ftPoint2(*to);
     return 0;
 }
@@ -173,7 +183,7 @@ bool getGlyphIndex(GlyphIndex &glyphIndex, FontHandle *font, unicode_t unicode)
     return glyphIndex.getIndex() != 0;
 }
 
-bool loadGlyph(Shape &output, FontHandle *font, GlyphIndex glyphIndex, double *advance) {
+bool loadGlyph(Shape &output, FontHandle *font, GlyphIndex glyphIndex, double *advance, EdgeArena *edgeArena) {
     if (!font)
         return false;
     FT_Error error = FT_Load_Glyph(font->face, glyphIndex.getIndex(), FT_LOAD_NO_SCALE);
@@ -186,6 +196,7 @@ bool loadGlyph(Shape &output, FontHandle *font, GlyphIndex glyphIndex, double *a
 
     FtContext context = { };
     context.shape = &output;
+    context.edgeArena = edgeArena;
     FT_Outline_Funcs ftFunctions;
     ftFunctions.move_to = &ftMoveTo;
     ftFunctions.line_to = &ftLineTo;
@@ -201,8 +212,8 @@ bool loadGlyph(Shape &output, FontHandle *font, GlyphIndex glyphIndex, double *a
     return true;
 }
 
-bool loadGlyph(Shape &output, FontHandle *font, unicode_t unicode, double *advance) {
-    return loadGlyph(output, font, GlyphIndex(FT_Get_Char_Index(font->face, unicode)), advance);
+bool loadGlyph(Shape &output, FontHandle *font, unicode_t unicode, double *advance, EdgeArena *edgeArena) {
+    return loadGlyph(output, font, GlyphIndex(FT_Get_Char_Index(font->face, unicode)), advance, edgeArena);
 }
 
 bool getKerning(double &output, FontHandle *font, GlyphIndex glyphIndex1, GlyphIndex glyphIndex2) {
@@ -3,6 +3,7 @@
 
 #include <cstdlib>
 #include "../core/Shape.h"
+#include "../core/EdgeArena.h"
 
 namespace msdfgen {
 
@@ -57,9 +58,9 @@ bool getFontMetrics(FontMetrics &metrics, FontHandle *font);
 bool getFontWhitespaceWidth(double &spaceAdvance, double &tabAdvance, FontHandle *font);
 /// Outputs the glyph index corresponding to the specified Unicode character.
 bool getGlyphIndex(GlyphIndex &glyphIndex, FontHandle *font, unicode_t unicode);
-/// Loads the geometry of a glyph from a font file.
-bool loadGlyph(Shape &output, FontHandle *font, GlyphIndex glyphIndex, double *advance = NULL);
-bool loadGlyph(Shape &output, FontHandle *font, unicode_t unicode, double *advance = NULL);
+/// Loads the geometry of a glyph from a font file. If edgeArena is not null, the glyph's edges are allocated from it.
+bool loadGlyph(Shape &output, FontHandle *font, GlyphIndex glyphIndex, double *advance = NULL, EdgeArena *edgeArena = NULL);
+bool loadGlyph(Shape &output, FontHandle *font, unicode_t unicode, double *advance = NULL, EdgeArena *edgeArena = NULL);
 /// Outputs the kerning distance adjustment between two specific glyphs.
 bool getKerning(double &output, FontHandle *font, GlyphIndex glyphIndex1, GlyphIndex glyphIndex2);
 bool getKerning(double &output, FontHandle *font, unicode_t unicode1, unicode_t unicode2);
@@ -142,6 +142,14 @@ static void invertColor(const BitmapRef<float, N> &bitmap) {
         *p = 1.f-*p;
 }
 
+template <int N>
+static float maxDifference(const BitmapConstRef<float, N> &a, const BitmapConstRef<float, N> &b) {
+    float difference = 0;
+    for (int i = 0; i < N*a.width*a.height; ++i)
+        difference = max(difference, fabsf(a.pixels[i]-b.pixels[i]));
+    return difference;
+}
+
 static bool writeTextBitmap(FILE *file, const float *values, int cols, int rows) {
     for (int row = 0; row < rows; ++row) {
         for (int col = 0; col < cols; ++col) {
@@ -328,6 +336,8 @@ static const char *helpText =
         "\tAttempts to detect if shape contours have the wrong winding and generates the SDF with the right one.\n"
     "  -help\n"
         "\tDisplays this help.\n"
+    "  -hierarchical <tolerance>\n"
+        "\tGenerates the MSDF coarse to fine, only computing distances where interpolation would exceed tolerance (in units of the range).\n"
     "  -legacy\n"
         "\tUses the original (legacy) distance field algorithms.\n"
 #ifdef MSDFGEN_USE_SKIA
@@ -339,16 +349,22 @@ static const char *helpText =
     "  -noscanline\n"
         "\tDisables the scanline pass, which corrects the distance field's signs according to the selected fill rule.\n"
 #endif
+    "  -nosimd\n"
+        "\tDisables computing the distances of several pixels at once using SIMD instructions.\n"
     "  -o <filename>\n"
         "\tSets the output file name. The default value is \"output.png\".\n"
 #ifdef MSDFGEN_USE_SKIA
     "  -overlap\n"
         "\tSwitches to distance field generator with support for overlapping contours.\n"
 #endif
+    "  -precisioncheck <tolerance>\n"
+        "\tGenerates the distance field in single precision, compares its estimated error to the double precision result and fails if it is larger by more than tolerance.\n"
     "  -printmetrics\n"
         "\tPrints relevant metrics of the shape to the standard output.\n"
     "  -pxrange <range>\n"
         "\tSets the width of the range between the lowest and highest signed distance in pixels.\n"
+    "  -quadratic <tolerance>\n"
+        "\tConverts cubic curves to quadratic curves within the tolerance (in pixels), which are faster to evaluate.\n"
     "  -range <range>\n"
         "\tSets the width of the range between the lowest and highest signed distance in shape units.\n"
     "  -reverseorder\n"
@@ -361,14 +377,24 @@ static const char *helpText =
 #endif
     "  -seed <n>\n"
         "\tSets the random seed for edge coloring heuristic.\n"
+    "  -simdcheck <tolerance>\n"
+        "\tAlso generates the distance field without SIMD, prints the largest difference and fails if it exceeds tolerance.\n"
+    "  -simplify <tolerance>\n"
+        "\tReduces the number of edges of the shape while keeping its outline within the tolerance (in pixels) of the original.\n"
+    "  -singleprecision\n"
+        "\tComputes distances in single precision, which is faster but less accurate.\n"
     "  -size <width> <height>\n"
         "\tSets the dimensions of the output image.\n"
+    "  -sparse\n"
+        "\tOnly computes distances of pixels within range of the shape, the rest are saturated. Exact for sdf, approximate for psdf, msdf, and mtsdf.\n"
     "  -stdout\n"
         "\tPrints the output instead of storing it in a file. Only text formats are supported.\n"
     "  -testrender <filename.png> <width> <height>\n"
         "\tRenders an image preview using the generated distance field and saves it as a PNG file.\n"
     "  -testrendermulti <filename.png> <width> <height>\n"
         "\tRenders an image preview without flattening the color channels.\n"
+    "  -threads <n>\n"
+        "\tSets the number of threads that generate the distance field in bands of rows. The default value of 0 uses one per CPU core.\n"
     "  -translate <x> <y>\n"
         "\tSets the translation of the shape in shape units.\n"
     "  -windingpreprocess\n"
@@ -433,6 +459,7 @@ int main(int argc, const char * const *argv) {
     bool legacyMode = false;
     MSDFGeneratorConfig generatorConfig;
     generatorConfig.overlapSupport = geometryPreproc == NO_PREPROCESS;
+    generatorConfig.threadCount = 0;
     bool scanlinePass = geometryPreproc == NO_PREPROCESS;
     FillRule fillRule = FILL_NONZERO;
     Format format = AUTO;
@@ -465,6 +492,15 @@ int main(int argc, const char * const *argv) {
     bool yFlip = false;
     bool printMetrics = false;
     bool estimateError = false;
+    bool simdCheck = false;
+    double simdCheckTolerance = 0;
+    bool simplify = false;
+    double simplifyTolerance = 0;
+    double quadraticTolerance = 0;
+    bool hierarchical = false;
+    double hierarchyTolerance = 0;
+    bool precisionCheck = false;
+    double precisionCheckTolerance = 0;
     bool skipColoring = false;
     enum {
         KEEP,
@@ -572,6 +608,64 @@ int main(int argc, const char * const *argv) {
             argPos += 1;
             continue;
         }
+        ARG_CASE("-nosimd", 0) {
+            generatorConfig.simd = false;
+            argPos += 1;
+            continue;
+        }
+        ARG_CASE("-quadratic", 1) {
+            if (!parseDouble(quadraticTolerance, argv[argPos+1]) || quadraticTolerance <= 0)
+                ABORT("Invalid quadratic conversion tolerance. Use -quadratic <tolerance> with a positive real number.");
+            argPos += 2;
+            continue;
+        }
+        ARG_CASE("-simplify", 1) {
+            if (!parseDouble(simplifyTolerance, argv[argPos+1]) || simplifyTolerance < 0)
+                ABORT("Invalid simplification tolerance. Use -simplify <tolerance> with a non-negative real number.");
+            simplify = true;
+            argPos += 2;
+            continue;
+        }
+        ARG_CASE("-simdcheck", 1) {
+            if (!parseDouble(simdCheckTolerance, argv[argPos+1]) || simdCheckTolerance < 0)
+                ABORT("Invalid SIMD check tolerance. Use -simdcheck <tolerance> with a non-negative real number.");
+            simdCheck = true;
+            argPos += 2;
+            continue;
+        }
+        ARG_CASE("-singleprecision", 0) {
+            generatorConfig.singlePrecision = true;
+            argPos += 1;
+            continue;
+        }
+        ARG_CASE("-sparse", 0) {
+            generatorConfig.sparse = true;
+            argPos += 1;
+            continue;
+        }
+        ARG_CASE("-hierarchical", 1) {
+            if (!parseDouble(hierarchyTolerance, argv[argPos+1]) || hierarchyTolerance < 0)
+                ABORT("Invalid hierarchical tolerance. Use -hierarchical <tolerance> with a non-negative real number.");
+            hierarchical = true;
+            argPos += 2;
+            continue;
+        }
+        ARG_CASE("-precisioncheck", 1) {
+            if (!parseDouble(precisionCheckTolerance, argv[argPos+1]) || precisionCheckTolerance < 0)
+                ABORT("Invalid precision check tolerance. Use -precisioncheck <tolerance> with a non-negative real number.");
+            generatorConfig.singlePrecision = true;
+            precisionCheck = true;
+            argPos += 2;
+            continue;
+        }
+        ARG_CASE("-threads", 1) {
+            unsigned tc;
+            if (!parseUnsigned(tc, argv[argPos+1]))
+                ABORT("Invalid thread count. Use -threads <N> with N being a non-negative integer.");
+            generatorConfig.threadCount = (int) tc;
+            argPos += 2;
+            continue;
+        }
         ARG_CASE("-noscanline", 0) {
             scanlinePass = false;
             argPos += 1;
@@ -945,6 +1039,20 @@ int main(int argc, const char * const *argv) {
     if (rangeMode == RANGE_PX)
         range = pxRange/min(scale.x, scale.y);
 
+    // Simplify shape
+    Shape originalShape;
+    if (estimateError && (simplify || quadraticTolerance > 0))
+        originalShape = shape;
+    const Shape &referenceShape = estimateError && (simplify || quadraticTolerance > 0) ? originalShape : shape;
+    if (simplify) {
+        int originalEdgeCount = shape.edgeCount();
+        shape.simplify(simplifyTolerance/min(scale.x, scale.y));
+        shape.normalize();
+        printf("Simplified shape from %d to %d edges.\n", originalEdgeCount, shape.edgeCount());
+    }
+    if (quadraticTolerance > 0)
+        shape.convertCubicsToQuadratics(quadraticTolerance/min(scale.x, scale.y));
+
     // Print metrics
     if (mode == METRICS || printMetrics) {
         FILE *out = stdout;
@@ -1016,6 +1124,8 @@ int main(int argc, const char * const *argv) {
             msdf = Bitmap<float, 3>(width, height);
             if (legacyMode)
                 generateMSDF_legacy(msdf, shape, range, scale, translate, generatorConfig.errorCorrection);
+            else if (hierarchical)
+                generateMSDF(msdf, shape, projection, range, generatorConfig, hierarchyTolerance);
             else
                 generateMSDF(msdf, shape, projection, range, generatorConfig);
             break;
@@ -1035,6 +1145,42 @@ int main(int argc, const char * const *argv) {
         default:;
     }
 
+    if (simdCheck && !legacyMode) {
+        MSDFGeneratorConfig scalarConfig(generatorConfig);
+        scalarConfig.simd = false;
+        float difference = 0;
+        switch (mode) {
+            case SINGLE: {
+                Bitmap<float, 1> scalarSdf(width, height);
+                generateSDF(scalarSdf, shape, projection, range, scalarConfig);
+                difference = maxDifference<1>(sdf, scalarSdf);
+                break;
+            }
+            case PSEUDO: {
+                Bitmap<float, 1> scalarSdf(width, height);
+                generatePseudoSDF(scalarSdf, shape, projection, range, scalarConfig);
+                difference = maxDifference<1>(sdf, scalarSdf);
+                break;
+            }
+            case MULTI: {
+                Bitmap<float, 3> scalarMsdf(width, height);
+                generateMSDF(scalarMsdf, shape, projection, range, scalarConfig);
+                difference = maxDifference<3>(msdf, scalarMsdf);
+                break;
+            }
+            case MULTI_AND_TRUE: {
+                Bitmap<float, 4> scalarMtsdf(width, height);
+                generateMTSDF(scalarMtsdf, shape, projection, range, scalarConfig);
+                difference = maxDifference<4>(mtsdf, scalarMtsdf);
+                break;
+            }
+            default:;
+        }
+        printf("SIMD difference from scalar = %e\n", difference);
+        if (difference > simdCheckTolerance)
+            ABORT("SIMD check failed, the difference exceeds the tolerance.");
+    }
+
     if (orientation == GUESS) {
         // Get sign of signed distance outside bounds
         Point2 p(bounds.l-(bounds.r-bounds.l)-1, bounds.b-(bounds.t-bounds.b)-1);
@@ -1060,19 +1206,70 @@ int main(int argc, const char * const *argv) {
         switch (mode) {
             case SINGLE:
             case PSEUDO:
-                distanceSignCorrection(sdf, shape, projection, fillRule);
+                distanceSignCorrection(sdf, shape, projection, fillRule, generatorConfig.threadCount);
                 break;
             case MULTI:
-                distanceSignCorrection(msdf, shape, projection, fillRule);
+                distanceSignCorrection(msdf, shape, projection, fillRule, generatorConfig.threadCount);
                 msdfErrorCorrection(msdf, shape, projection, range, postErrorCorrectionConfig);
                 break;
             case MULTI_AND_TRUE:
-                distanceSignCorrection(mtsdf, shape, projection, fillRule);
+                distanceSignCorrection(mtsdf, shape, projection, fillRule, generatorConfig.threadCount);
                 msdfErrorCorrection(msdf, shape, projection, range, postErrorCorrectionConfig);
                 break;
             default:;
         }
     }
+    if (precisionCheck && !legacyMode) {
+        // The double precision reference undergoes the same post-processing before both errors are estimated
+        MSDFGeneratorConfig doubleConfig(generatorConfig);
+        doubleConfig.singlePrecision = false;
+        double singleError = 0, doubleError = 0;
+        switch (mode) {
+            case SINGLE:
+            case PSEUDO: {
+                Bitmap<float, 1> doubleSdf(width, height);
+                if (mode == SINGLE)
+                    generateSDF(doubleSdf, shape, projection, range, doubleConfig);
+                else
+                    generatePseudoSDF(doubleSdf, shape, projection, range, doubleConfig);
+                if (orientation == REVERSE)
+                    invertColor<1>(doubleSdf);
+                if (scanlinePass)
+                    distanceSignCorrection(doubleSdf, shape, projection, fillRule, generatorConfig.threadCount);
+                singleError = estimateSDFError(sdf, shape, projection, SDF_ERROR_ESTIMATE_PRECISION, fillRule);
+                doubleError = estimateSDFError(doubleSdf, shape, projection, SDF_ERROR_ESTIMATE_PRECISION, fillRule);
+                break;
+            }
+            case MULTI: {
+                Bitmap<float, 3> doubleMsdf(width, height);
+                generateMSDF(doubleMsdf, shape, projection, range, doubleConfig);
+                if (orientation == REVERSE)
+                    invertColor<3>(doubleMsdf);
+                if (scanlinePass) {
+                    distanceSignCorrection(doubleMsdf, shape, projection, fillRule, generatorConfig.threadCount);
+                    msdfErrorCorrection(doubleMsdf, shape, projection, range, postErrorCorrectionConfig);
+                }
+                singleError = estimateSDFError(msdf, shape, projection, SDF_ERROR_ESTIMATE_PRECISION, fillRule);
+                doubleError = estimateSDFError(doubleMsdf, shape, projection, SDF_ERROR_ESTIMATE_PRECISION, fillRule);
+                break;
+            }
+            case MULTI_AND_TRUE: {
+                Bitmap<float, 4> doubleMtsdf(width, height);
+                generateMTSDF(doubleMtsdf, shape, projection, range, doubleConfig);
+                if (orientation == REVERSE)
+                    invertColor<4>(doubleMtsdf);
+                if (scanlinePass)
+                    distanceSignCorrection(doubleMtsdf, shape, projection, fillRule, generatorConfig.threadCount);
+                singleError = estimateSDFError(mtsdf, shape, projection, SDF_ERROR_ESTIMATE_PRECISION, fillRule);
+                doubleError = estimateSDFError(doubleMtsdf, shape, projection, SDF_ERROR_ESTIMATE_PRECISION, fillRule);
+                break;
+            }
+            default:;
+        }
+        printf("SDF error ~ %e in single precision, %e in double precision\n", singleError, doubleError);
+        if (singleError > doubleError+precisionCheckTolerance)
+            ABORT("Precision check failed, the single precision error exceeds the tolerance.");
+    }
     if (outputDistanceShift) {
         float *pixel = NULL, *pixelsEnd = NULL;
         switch (mode) {
@@ -1114,7 +1311,7 @@ int main(int argc, const char * const *argv) {
             if (is8bitFormat(format) && (testRenderMulti || testRender || estimateError))
                 simulate8bit(sdf);
             if (estimateError) {
-                double sdfError = estimateSDFError(sdf, shape, projection, SDF_ERROR_ESTIMATE_PRECISION, fillRule);
+                double sdfError = estimateSDFError(sdf, referenceShape, projection, SDF_ERROR_ESTIMATE_PRECISION, fillRule);
                 printf("SDF error ~ %e\n", sdfError);
             }
             if (testRenderMulti) {
@@ -1137,7 +1334,7 @@ int main(int argc, const char * const *argv) {
             if (is8bitFormat(format) && (testRenderMulti || testRender || estimateError))
                 simulate8bit(msdf);
             if (estimateError) {
-                double sdfError = estimateSDFError(msdf, shape, projection, SDF_ERROR_ESTIMATE_PRECISION, fillRule);
+                double sdfError = estimateSDFError(msdf, referenceShape, projection, SDF_ERROR_ESTIMATE_PRECISION, fillRule);
                 printf("SDF error ~ %e\n", sdfError);
             }
             if (testRenderMulti) {
@@ -1160,7 +1357,7 @@ int main(int argc, const char * const *argv) {
             if (is8bitFormat(format) && (testRenderMulti || testRender || estimateError))
                 simulate8bit(mtsdf);
             if (estimateError) {
-                double sdfError = estimateSDFError(mtsdf, shape, projection, SDF_ERROR_ESTIMATE_PRECISION, fillRule);
+                double sdfError = estimateSDFError(mtsdf, referenceShape, projection, SDF_ERROR_ESTIMATE_PRECISION, fillRule);
                 printf("SDF error ~ %e\n", sdfError);
             }
             if (testRenderMulti) {
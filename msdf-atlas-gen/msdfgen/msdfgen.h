@@ -19,13 +19,16 @@
 #include "core/Vector2.h"
 #include "core/Projection.h"
 #include "core/Scanline.h"
+#include "core/ScanlineSweep.h"
 #include "core/Shape.h"
+#include "core/EdgeArena.h"
 #include "core/BitmapRef.hpp"
 #include "core/Bitmap.h"
 #include "core/bitmap-interpolation.hpp"
 #include "core/pixel-conversion.hpp"
 #include "core/edge-coloring.h"
 #include "core/generator-config.h"
+#include "core/GeneratorContext.h"
 #include "core/msdf-error-correction.h"
 #include "core/render-sdf.h"
 #include "core/rasterization.h"
@@ -47,9 +50,22 @@ void generatePseudoSDF(const BitmapRef<float, 1> &output, const Shape &shape, co
 /// Generates a multi-channel signed distance field. Edge colors must be assigned first! (See edgeColoringSimple)
 void generateMSDF(const BitmapRef<float, 3> &output, const Shape &shape, const Projection &projection, double range, const MSDFGeneratorConfig &config = MSDFGeneratorConfig());
 
+/// Generates a multi-channel signed distance field, only computing the exact distances where needed to bilinearly interpolate the rest.
+/// Cells of pixels are recursively subdivided where the shape's edges pass, the channels disagree, or the interpolation error exceeds tolerance,
+/// which is measured in units of the range. Intended for large images of a single shape.
+void generateMSDF(const BitmapRef<float, 3> &output, const Shape &shape, const Projection &projection, double range, const MSDFGeneratorConfig &config, double tolerance);
+
 /// Generates a multi-channel signed distance field with true distance in the alpha channel. Edge colors must be assigned first.
 void generateMTSDF(const BitmapRef<float, 4> &output, const Shape &shape, const Projection &projection, double range, const MSDFGeneratorConfig &config = MSDFGeneratorConfig());
 
+/// Generates a multi-channel signed distance field whose signs are corrected to match the shape's fill (see distanceSignCorrection), followed by error correction
+/// without the exact distance check, which would be invalidated by the corrected signs. Same as generateMSDF with error correction disabled, distanceSignCorrection,
+/// and msdfErrorCorrection with DO_NOT_CHECK_DISTANCE, but if config.threadCount is 1, all of them are carried out in a single pass over the rows of the bitmap.
+void generateSignCorrectedMSDF(const BitmapRef<float, 3> &output, const Shape &shape, const Projection &projection, double range, const MSDFGeneratorConfig &config = MSDFGeneratorConfig(), FillRule fillRule = FILL_NONZERO);
+
+/// Generates a multi-channel signed distance field with true distance in the alpha channel whose signs are corrected to match the shape's fill (see generateSignCorrectedMSDF).
+void generateSignCorrectedMTSDF(const BitmapRef<float, 4> &output, const Shape &shape, const Projection &projection, double range, const MSDFGeneratorConfig &config = MSDFGeneratorConfig(), FillRule fillRule = FILL_NONZERO);
+
 // Old version of the function API's kept for backwards compatibility
 void generateSDF(const BitmapRef<float, 1> &output, const Shape &shape, double range, const Vector2 &scale, const Vector2 &translate, bool overlapSupport = true);
 void generatePseudoSDF(const BitmapRef<float, 1> &output, const Shape &shape, double range, const Vector2 &scale, const Vector2 &translate, bool overlapSupport = true);
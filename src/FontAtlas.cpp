@@ -10,6 +10,8 @@
 #include "Renderer.hpp"
 #include "Shader.hpp"
 
+#include <algorithm>
+
 
 static std::map<unsigned int, std::map<std::pair<uint32_t, uint32_t>, double>> fontKerns;
 static std::map<unsigned int, std::map<uint32_t, double>> fontAdvances;
@@ -17,18 +19,60 @@ static std::map<unsigned int, std::map<uint32_t, std::tuple<float, float, float,
 static std::map<unsigned int, std::map<uint32_t, std::tuple<float, float, float, float>>> fontQuadBounds;
 static std::map<unsigned int, std::tuple<double, double, double>> fontVerticalMetrics;
 
+// stores the layout metrics of the glyphs packed into an atlas texture so the getters can look them up by texture
+static void StoreFontMetrics(unsigned int texture, const std::vector<msdf_atlas::GlyphGeometry>& glyphs, const msdf_atlas::FontGeometry& fontGeometry, int atlasWidth, int atlasHeight)
+{
+	std::map<int, uint32_t> indexToCodePoint;
+	for (const msdf_atlas::GlyphGeometry& glyph : glyphs)
+	{
+		indexToCodePoint[glyph.getIndex()] = glyph.getCodepoint();
+		fontAdvances[texture][glyph.getCodepoint()] = glyph.getAdvance();
+
+		double l, b, r, t;
+		glyph.getQuadAtlasBounds(l, b, r, t);
+		l /= atlasWidth;
+		r /= atlasWidth;
+		b /= atlasHeight;
+		t /= atlasHeight;
+		fontUVBounds[texture][glyph.getCodepoint()] = std::tuple(l, r, b, t);
+
+		glyph.getQuadPlaneBounds(l, b, r, t);
+		fontQuadBounds[texture][glyph.getCodepoint()] = std::tuple(l, r, b, t);
+	}
+
+	msdfgen::FontMetrics metrics = fontGeometry.getMetrics();
+	fontVerticalMetrics[texture] = std::tuple
+	(
+		metrics.lineHeight,
+		metrics.ascenderY,
+		-metrics.descenderY
+	);
+
+	for (auto& [indicesKey, kernVal] : fontGeometry.getKerning())
+	{
+		std::pair<uint32_t, uint32_t> codePointsKey
+		(
+			indexToCodePoint[indicesKey.first],
+			indexToCodePoint[indicesKey.second]
+		);
+		fontKerns[texture][codePointsKey] = kernVal;
+	}
+}
+
 // generation of font atlas copied from: https://github.com/Chlumsky/msdf-atlas-gen
-void FontAtlas::Initialize(std::string fontFilename) {
+void FontAtlas::Initialize(std::string fontFilename, const std::vector<int>& coverageSizes) {
 	using namespace msdf_atlas;
 	// Initialize instance of FreeType library
 	if (msdfgen::FreetypeHandle* ft = msdfgen::initializeFreetype()) {
 		// Load font file
 		if (msdfgen::FontHandle* font = msdfgen::loadFont(ft, fontFilename.c_str())) {
+			// Arena for the edges of the loaded glyphs, declared first so that it outlives them
+			msdfgen::EdgeArena edgeArena;
 			// Storage for glyph geometry and their coordinates in the atlas
 			std::vector<msdf_atlas::GlyphGeometry> glyphs;
 			// FontGeometry is a helper class that loads a set of glyphs from a single font.
 			// It can also be used to get additional font metrics, kerning information, etc.
-			msdf_atlas::FontGeometry fontGeometry = FontGeometry(&glyphs);
+			msdf_atlas::FontGeometry fontGeometry = FontGeometry(&glyphs, &edgeArena);
 			// Load a set of character glyphs:
 			// The second argument can be ignored unless you mix different font sizes in one atlas.
 			// In the last argument, you can specify a charset other than ASCII.
@@ -36,8 +80,7 @@ void FontAtlas::Initialize(std::string fontFilename) {
 			fontGeometry.loadCharset(font, 1.0, Charset::ASCII);
 			// Apply MSDF edge coloring. See edge-coloring.h for other coloring strategies.
 			const double maxCornerAngle = 3.0;
-			for (GlyphGeometry& glyph : glyphs)
-				glyph.edgeColoring(&msdfgen::edgeColoringInkTrap, maxCornerAngle, 0);
+			edgeColoringBatch(glyphs.data(), (int) glyphs.size(), &msdfgen::edgeColoringInkTrap, maxCornerAngle, 0, 4);
 			// TightAtlasPacker class computes the layout of the atlas.
 			TightAtlasPacker packer;
 			// Set atlas parameters:
@@ -116,40 +159,11 @@ void FontAtlas::Initialize(std::string fontFilename) {
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 			glBindTexture(GL_TEXTURE_2D, 0);
 
-			std::map<int, uint32_t> indexToCodePoint;
-			for (const msdf_atlas::GlyphGeometry& glyph : glyphs)
-			{
-				indexToCodePoint[glyph.getIndex()] = glyph.getCodepoint();
-				fontAdvances[this->fontTexture_][glyph.getCodepoint()] = glyph.getAdvance();
-
-				double l, b, r, t;
-				glyph.getQuadAtlasBounds(l, b, r, t);
-				l /= bitmap.width;
-				r /= bitmap.width;
-				b /= bitmap.height;
-				t /= bitmap.height;
-				fontUVBounds[this->fontTexture_][glyph.getCodepoint()] = std::tuple(l, r, b, t);
-
-				glyph.getQuadPlaneBounds(l, b, r, t);
-				fontQuadBounds[this->fontTexture_][glyph.getCodepoint()] = std::tuple(l, r, b, t);
-			}
-
-			msdfgen::FontMetrics metrics = fontGeometry.getMetrics();
-			fontVerticalMetrics[this->fontTexture_] = std::tuple
-			(
-				metrics.lineHeight,
-				metrics.ascenderY,
-				-metrics.descenderY
-			);
+			StoreFontMetrics(this->fontTexture_, glyphs, fontGeometry, bitmap.width, bitmap.height);
 
-			for (auto& [indicesKey, kernVal] : fontGeometry.getKerning())
+			for (int pixelSize : coverageSizes)
 			{
-				std::pair<uint32_t, uint32_t> codePointsKey
-				(
-					indexToCodePoint[indicesKey.first],
-					indexToCodePoint[indicesKey.second]
-				);
-				fontKerns[this->fontTexture_][codePointsKey] = kernVal;
+				InitializeCoverageAtlas(glyphs, fontGeometry, pixelSize);
 			}
 
 			msdfgen::destroyFont(font);
@@ -161,16 +175,62 @@ void FontAtlas::Initialize(std::string fontFilename) {
 	}
 }
 
+void FontAtlas::InitializeCoverageAtlas(const std::vector<msdf_atlas::GlyphGeometry>& glyphs, const msdf_atlas::FontGeometry& fontGeometry, int pixelSize)
+{
+	using namespace msdf_atlas;
+	// the glyph boxes are recomputed by the packer, so the coverage atlas gets its own copy of the geometry
+	std::vector<GlyphGeometry> coverageGlyphs = glyphs;
+
+	TightAtlasPacker packer;
+	packer.setDimensionsConstraint(TightAtlasPacker::DimensionsConstraint::POWER_OF_TWO_RECTANGLE);
+	// one em is rendered at exactly the target size
+	packer.setScale(pixelSize);
+	// the glyphs are rasterized with their exact area coverage (msdf-atlas-gen -type softmask), the range only adds a margin to their boxes
+	packer.setPixelRange(1.0);
+	packer.setMiterLimit(1.0);
+	// keeps linear filtering from blending in neighbouring glyphs
+	packer.setPadding(1);
+	packer.pack(coverageGlyphs.data(), coverageGlyphs.size());
+	int width = 0, height = 0;
+	packer.getDimensions(width, height);
+
+	ImmediateAtlasGenerator<float, 1, &coverageGenerator, BitmapAtlasStorage<byte, 1>> generator(width, height);
+	GeneratorAttributes attributes;
+	generator.setAttributes(attributes);
+	generator.setThreadCount(4);
+	generator.generate(coverageGlyphs.data(), coverageGlyphs.size());
+
+	msdfgen::BitmapConstRef<unsigned char, 1> bitmap = generator.atlasStorage();
+
+	unsigned int texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, bitmap.pixels);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	StoreFontMetrics(texture, coverageGlyphs, fontGeometry, bitmap.width, bitmap.height);
+	coverageAtlases_.push_back(CoverageAtlas{ pixelSize, texture });
+}
+
+// the getters only use find() so that text can be laid out from several threads at once,
+// operator[] would insert missing entries into the shared maps
 void FontAtlas::GetFontCharUVBounds(unsigned int atlas, uint32_t unicodeChar, float& out_l, float& out_r, float& out_b, float& out_t)
 {
-	if (fontUVBounds.count(atlas) > 0)
+	auto atlasBounds = fontUVBounds.find(atlas);
+	if (atlasBounds != fontUVBounds.end())
 	{
-		if (fontUVBounds[atlas].count(unicodeChar) > 0)
+		auto bounds = atlasBounds->second.find(unicodeChar);
+		if (bounds != atlasBounds->second.end())
 		{
-			out_l = std::get<0>(fontUVBounds[atlas][unicodeChar]);
-			out_r = std::get<1>(fontUVBounds[atlas][unicodeChar]);
-			out_b = std::get<2>(fontUVBounds[atlas][unicodeChar]);
-			out_t = std::get<3>(fontUVBounds[atlas][unicodeChar]);
+			out_l = std::get<0>(bounds->second);
+			out_r = std::get<1>(bounds->second);
+			out_b = std::get<2>(bounds->second);
+			out_t = std::get<3>(bounds->second);
 		}
 		else
 		{
@@ -185,18 +245,25 @@ void FontAtlas::GetFontCharUVBounds(unsigned int atlas, uint32_t unicodeChar, fl
 
 void FontAtlas::GetFontCharQuadBounds(unsigned int atlas, uint32_t unicodeChar, float& out_l, float& out_r, float& out_b, float& out_t, uint32_t prevChar)
 {
-	if (fontQuadBounds.count(atlas) > 0)
+	auto atlasBounds = fontQuadBounds.find(atlas);
+	if (atlasBounds != fontQuadBounds.end())
 	{
-		if (fontQuadBounds[atlas].count(unicodeChar) > 0)
+		auto bounds = atlasBounds->second.find(unicodeChar);
+		if (bounds != atlasBounds->second.end())
 		{
-			out_l = std::get<0>(fontQuadBounds[atlas][unicodeChar]);
-			out_r = std::get<1>(fontQuadBounds[atlas][unicodeChar]);
-			out_b = std::get<2>(fontQuadBounds[atlas][unicodeChar]);
-			out_t = std::get<3>(fontQuadBounds[atlas][unicodeChar]);
+			out_l = std::get<0>(bounds->second);
+			out_r = std::get<1>(bounds->second);
+			out_b = std::get<2>(bounds->second);
+			out_t = std::get<3>(bounds->second);
 
-			if (fontKerns[atlas].count(std::pair(unicodeChar, prevChar)) > 0)
+			auto atlasKerns = fontKerns.find(atlas);
+			if (atlasKerns != fontKerns.end())
 			{
-				out_l += fontKerns[atlas][std::pair(unicodeChar, prevChar)];
+				auto kern = atlasKerns->second.find(std::pair(unicodeChar, prevChar));
+				if (kern != atlasKerns->second.end())
+				{
+					out_l += kern->second;
+				}
 			}
 		}
 		else
@@ -212,11 +279,13 @@ void FontAtlas::GetFontCharQuadBounds(unsigned int atlas, uint32_t unicodeChar,
 
 double FontAtlas::GetFontCharAdvance(unsigned int atlas, uint32_t unicodeChar)
 {
-	if (fontAdvances.count(atlas) > 0)
+	auto atlasAdvances = fontAdvances.find(atlas);
+	if (atlasAdvances != fontAdvances.end())
 	{
-		if (fontAdvances[atlas].count(unicodeChar) > 0)
+		auto advance = atlasAdvances->second.find(unicodeChar);
+		if (advance != atlasAdvances->second.end())
 		{
-			return fontAdvances[atlas][unicodeChar];
+			return advance->second;
 		}
 		else
 		{
@@ -233,11 +302,12 @@ double FontAtlas::GetFontCharAdvance(unsigned int atlas, uint32_t unicodeChar)
 
 void FontAtlas::GetFontVerticalMetrics(unsigned int atlas, double& out_lineHeight, double& out_ascenderHeight, double& out_descenderHeight)
 {
-	if (fontVerticalMetrics.count(atlas) > 0)
+	auto metrics = fontVerticalMetrics.find(atlas);
+	if (metrics != fontVerticalMetrics.end())
 	{
-		out_lineHeight = std::get<0>(fontVerticalMetrics[atlas]);
-		out_ascenderHeight = std::get<1>(fontVerticalMetrics[atlas]);
-		out_descenderHeight = std::get<2>(fontVerticalMetrics[atlas]);
+		out_lineHeight = std::get<0>(metrics->second);
+		out_ascenderHeight = std::get<1>(metrics->second);
+		out_descenderHeight = std::get<2>(metrics->second);
 	}
 	else
 	{
@@ -250,6 +320,36 @@ unsigned int FontAtlas::GetTexture()
 	return fontTexture_;
 }
 
+bool FontAtlas::GetCoverageTexture(float pixelsPerEm, unsigned int& out_texture)
+{
+	if (coverageAtlases_.empty())
+	{
+		return false;
+	}
+
+	// the smallest atlas that does not have to be magnified, or the largest one
+	for (const CoverageAtlas& coverageAtlas : coverageAtlases_)
+	{
+		if (coverageAtlas.pixelSize >= pixelsPerEm)
+		{
+			out_texture = coverageAtlas.texture;
+			return true;
+		}
+	}
+	out_texture = coverageAtlases_.back().texture;
+	return true;
+}
+
+std::vector<unsigned int> FontAtlas::GetCoverageTextures()
+{
+	std::vector<unsigned int> textures;
+	for (const CoverageAtlas& coverageAtlas : coverageAtlases_)
+	{
+		textures.push_back(coverageAtlas.texture);
+	}
+	return textures;
+}
+
 unsigned int FontAtlas::GetVBO()
 {
 	return vbo_;
@@ -260,7 +360,8 @@ unsigned int FontAtlas::GetQuadVAO()
 	return quadVAO_;
 }
 
-FontAtlas::FontAtlas(std::string fontFile)
+FontAtlas::FontAtlas(std::string fontFile, std::vector<int> coverageSizes)
 {
-	this->Initialize(fontFile);
+	std::sort(coverageSizes.begin(), coverageSizes.end());
+	this->Initialize(fontFile, coverageSizes);
 }
\ No newline at end of file
@@ -1,3 +1,5 @@
+#pragma once
+
 #include <string>
 #include <memory>
 #include <map>
@@ -5,6 +7,12 @@
 
 #include "glm/glm.hpp"
 
+namespace msdf_atlas
+{
+	class GlyphGeometry;
+	class FontGeometry;
+}
+
 class Texture;
 struct VertexData
 {
@@ -20,12 +28,22 @@ class FontAtlas
 	unsigned int vbo_;
 	unsigned int fontTexture_;
 
-	void Initialize(std::string fontFile);
+	// antialiased coverage atlases at fixed pixel sizes for tiny text, sorted by size
+	struct CoverageAtlas
+	{
+		int pixelSize;
+		unsigned int texture;
+	};
+	std::vector<CoverageAtlas> coverageAtlases_;
+
+	void Initialize(std::string fontFile, const std::vector<int>& coverageSizes);
+	void InitializeCoverageAtlas(const std::vector<msdf_atlas::GlyphGeometry>& glyphs, const msdf_atlas::FontGeometry& fontGeometry, int pixelSize);
 
 
 	
 public:
-	FontAtlas(std::string fontFile);
+	// coverageSizes are the pixels per em of the optional coverage atlases used for tiny text
+	FontAtlas(std::string fontFile, std::vector<int> coverageSizes = {});
 
 	void GetFontCharUVBounds(unsigned int atlas, uint32_t unicodeChar, float& out_l, float& out_r, float& out_b, float& out_t);
 	void GetFontCharQuadBounds(unsigned int atlas, uint32_t unicodeChar, float& out_l, float& out_r, float& out_b, float& out_t, uint32_t prevChar);
@@ -33,6 +51,9 @@ public:
 	void GetFontVerticalMetrics(unsigned int atlas, double& out_lineHeight, double& out_ascenderHeight, double& out_descenderHeight);
 
 	unsigned int GetTexture();
+	// picks the coverage atlas for text rendered at pixelsPerEm, returns false if the font has none
+	bool GetCoverageTexture(float pixelsPerEm, unsigned int& out_texture);
+	std::vector<unsigned int> GetCoverageTextures();
 	unsigned int GetVBO();
 	unsigned int GetQuadVAO();
 
@@ -0,0 +1,217 @@
+#include "GlyphQuadEmitter.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define GLYPH_EMITTER_AVX 1
+#else
+#define GLYPH_EMITTER_AVX 0
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GLYPH_EMITTER_SSE2 1
+#else
+#define GLYPH_EMITTER_SSE2 0
+#endif
+
+
+static_assert(sizeof(VertexData) == 9 * sizeof(float), "VertexData is expected to be 9 tightly packed floats");
+
+size_t GlyphQuadMetrics::Size() const
+{
+	return cursorX.size();
+}
+
+void GlyphQuadMetrics::Clear()
+{
+	planeL.clear(); planeR.clear(); planeB.clear(); planeT.clear();
+	uvL.clear(); uvR.clear(); uvB.clear(); uvT.clear();
+	cursorX.clear(); alignX.clear(); lineY.clear();
+}
+
+void GlyphQuadMetrics::Reserve(size_t glyphCount)
+{
+	planeL.reserve(glyphCount); planeR.reserve(glyphCount); planeB.reserve(glyphCount); planeT.reserve(glyphCount);
+	uvL.reserve(glyphCount); uvR.reserve(glyphCount); uvB.reserve(glyphCount); uvT.reserve(glyphCount);
+	cursorX.reserve(glyphCount); alignX.reserve(glyphCount); lineY.reserve(glyphCount);
+}
+
+// writes position and uv of the vertices lt, rb, lb, lt, rt, rb
+static inline void WriteQuad(VertexData* quad, float x0, float x1, float y0, float y1, float u0, float u1, float v0, float v1)
+{
+#if GLYPH_EMITTER_SSE2
+	// position.xyz and atlasUV.x are contiguous, so each vertex is one unaligned 4 wide store plus atlasUV.y
+	float* out = reinterpret_cast<float*>(quad);
+	const __m128 lt = _mm_setr_ps(x0, y1, 0.0f, u0);
+	const __m128 rb = _mm_setr_ps(x1, y0, 0.0f, u1);
+	_mm_storeu_ps(out, lt); out[4] = v1;
+	_mm_storeu_ps(out + 9, rb); out[13] = v0;
+	_mm_storeu_ps(out + 18, _mm_setr_ps(x0, y0, 0.0f, u0)); out[22] = v0;
+	_mm_storeu_ps(out + 27, lt); out[31] = v1;
+	_mm_storeu_ps(out + 36, _mm_setr_ps(x1, y1, 0.0f, u1)); out[40] = v1;
+	_mm_storeu_ps(out + 45, rb); out[49] = v0;
+#else
+	quad[0].ep_position = glm::vec3(x0, y1, 0.0f); quad[0].atlasUV = { u0, v1 }; //lt
+	quad[1].ep_position = glm::vec3(x1, y0, 0.0f); quad[1].atlasUV = { u1, v0 }; //rb
+	quad[2].ep_position = glm::vec3(x0, y0, 0.0f); quad[2].atlasUV = { u0, v0 }; //lb
+	quad[3].ep_position = glm::vec3(x0, y1, 0.0f); quad[3].atlasUV = { u0, v1 }; //lt
+	quad[4].ep_position = glm::vec3(x1, y1, 0.0f); quad[4].atlasUV = { u1, v1 }; //rt
+	quad[5].ep_position = glm::vec3(x1, y0, 0.0f); quad[5].atlasUV = { u1, v0 }; //rb
+#endif
+}
+
+void EmitGlyphQuads(const GlyphQuadMetrics& metrics, float size, double yoffset, VertexData* out_vertices)
+{
+	// we render each letter as two triangles with 3 verts each
+	const int vertsPerCharacter = 6;
+
+	const size_t glyphCount = metrics.Size();
+	size_t i = 0;
+
+	// the arithmetic is done in double precision like the scalar path, so all paths produce the same vertices
+#if GLYPH_EMITTER_AVX || GLYPH_EMITTER_SSE2
+	alignas(16) float x0[4], x1[4], y0[4], y1[4];
+#endif
+
+#if GLYPH_EMITTER_AVX
+	const __m256d sizeWide = _mm256_set1_pd(size);
+	const __m256d yoffsetWide = _mm256_set1_pd(yoffset);
+	for (; i + 4 <= glyphCount; i += 4)
+	{
+		const __m256d penX = _mm256_loadu_pd(&metrics.cursorX[i]);
+		const __m256d alignX = _mm256_loadu_pd(&metrics.alignX[i]);
+		const __m256d lineY = _mm256_loadu_pd(&metrics.lineY[i]);
+
+		// size * (l + cursorPos + xoffset)
+		_mm_store_ps(x0, _mm256_cvtpd_ps(_mm256_mul_pd(sizeWide, _mm256_add_pd(_mm256_add_pd(_mm256_cvtps_pd(_mm_loadu_ps(&metrics.planeL[i])), penX), alignX))));
+		_mm_store_ps(x1, _mm256_cvtpd_ps(_mm256_mul_pd(sizeWide, _mm256_add_pd(_mm256_add_pd(_mm256_cvtps_pd(_mm_loadu_ps(&metrics.planeR[i])), penX), alignX))));
+		// size * (b - currentLine * fontLineHeight + yoffset)
+		_mm_store_ps(y0, _mm256_cvtpd_ps(_mm256_mul_pd(sizeWide, _mm256_add_pd(_mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(&metrics.planeB[i])), lineY), yoffsetWide))));
+		_mm_store_ps(y1, _mm256_cvtpd_ps(_mm256_mul_pd(sizeWide, _mm256_add_pd(_mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(&metrics.planeT[i])), lineY), yoffsetWide))));
+
+		for (int j = 0; j < 4; j++)
+		{
+			WriteQuad(out_vertices + (i + j) * vertsPerCharacter, x0[j], x1[j], y0[j], y1[j], metrics.uvL[i + j], metrics.uvR[i + j], metrics.uvB[i + j], metrics.uvT[i + j]);
+		}
+	}
+#elif GLYPH_EMITTER_SSE2
+	const __m128d sizeWide = _mm_set1_pd(size);
+	const __m128d yoffsetWide = _mm_set1_pd(yoffset);
+	for (; i + 4 <= glyphCount; i += 4)
+	{
+		// two glyphs per double vector, the float results of both halves are packed into one vector
+		__m128d lo, hi;
+		const __m128d penXLo = _mm_loadu_pd(&metrics.cursorX[i]), penXHi = _mm_loadu_pd(&metrics.cursorX[i + 2]);
+		const __m128d alignXLo = _mm_loadu_pd(&metrics.alignX[i]), alignXHi = _mm_loadu_pd(&metrics.alignX[i + 2]);
+		const __m128d lineYLo = _mm_loadu_pd(&metrics.lineY[i]), lineYHi = _mm_loadu_pd(&metrics.lineY[i + 2]);
+
+		__m128 plane = _mm_loadu_ps(&metrics.planeL[i]);
+		lo = _mm_mul_pd(sizeWide, _mm_add_pd(_mm_add_pd(_mm_cvtps_pd(plane), penXLo), alignXLo));
+		hi = _mm_mul_pd(sizeWide, _mm_add_pd(_mm_add_pd(_mm_cvtps_pd(_mm_movehl_ps(plane, plane)), penXHi), alignXHi));
+		_mm_store_ps(x0, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+
+		plane = _mm_loadu_ps(&metrics.planeR[i]);
+		lo = _mm_mul_pd(sizeWide, _mm_add_pd(_mm_add_pd(_mm_cvtps_pd(plane), penXLo), alignXLo));
+		hi = _mm_mul_pd(sizeWide, _mm_add_pd(_mm_add_pd(_mm_cvtps_pd(_mm_movehl_ps(plane, plane)), penXHi), alignXHi));
+		_mm_store_ps(x1, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+
+		plane = _mm_loadu_ps(&metrics.planeB[i]);
+		lo = _mm_mul_pd(sizeWide, _mm_add_pd(_mm_sub_pd(_mm_cvtps_pd(plane), lineYLo), yoffsetWide));
+		hi = _mm_mul_pd(sizeWide, _mm_add_pd(_mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(plane, plane)), lineYHi), yoffsetWide));
+		_mm_store_ps(y0, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+
+		plane = _mm_loadu_ps(&metrics.planeT[i]);
+		lo = _mm_mul_pd(sizeWide, _mm_add_pd(_mm_sub_pd(_mm_cvtps_pd(plane), lineYLo), yoffsetWide));
+		hi = _mm_mul_pd(sizeWide, _mm_add_pd(_mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(plane, plane)), lineYHi), yoffsetWide));
+		_mm_store_ps(y1, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+
+		for (int j = 0; j < 4; j++)
+		{
+			WriteQuad(out_vertices + (i + j) * vertsPerCharacter, x0[j], x1[j], y0[j], y1[j], metrics.uvL[i + j], metrics.uvR[i + j], metrics.uvB[i + j], metrics.uvT[i + j]);
+		}
+	}
+#endif
+
+	// remaining glyphs (or all of them without SIMD support)
+	for (; i < glyphCount; i++)
+	{
+		const double penX = metrics.cursorX[i];
+		const double alignX = metrics.alignX[i];
+		const double lineY = metrics.lineY[i];
+		WriteQuad(out_vertices + i * vertsPerCharacter,
+			float(size * (metrics.planeL[i] + penX + alignX)),
+			float(size * (metrics.planeR[i] + penX + alignX)),
+			float(size * (metrics.planeB[i] - lineY + yoffset)),
+			float(size * (metrics.planeT[i] - lineY + yoffset)),
+			metrics.uvL[i], metrics.uvR[i], metrics.uvB[i], metrics.uvT[i]);
+	}
+}
+
+void ClipGlyphQuads(std::vector<VertexData>& vertices, glm::vec2 min, glm::vec2 max)
+{
+	const int vertsPerCharacter = 6;
+
+	size_t kept = 0;
+	for (size_t first = 0; first + vertsPerCharacter <= vertices.size(); first += vertsPerCharacter)
+	{
+		// lb and rt hold all bounds of the quad
+		const VertexData lb = vertices[first + 2];
+		const VertexData rt = vertices[first + 4];
+		float x0 = lb.ep_position.x, y0 = lb.ep_position.y, x1 = rt.ep_position.x, y1 = rt.ep_position.y;
+		float u0 = lb.atlasUV.x, v0 = lb.atlasUV.y, u1 = rt.atlasUV.x, v1 = rt.atlasUV.y;
+
+		if (x1 <= min.x || x0 >= max.x || y1 <= min.y || y0 >= max.y)
+		{
+			continue;
+		}
+
+		if (x0 < min.x)
+		{
+			u0 += (u1 - u0) * (min.x - x0) / (x1 - x0);
+			x0 = min.x;
+		}
+		if (x1 > max.x)
+		{
+			u1 -= (u1 - u0) * (x1 - max.x) / (x1 - x0);
+			x1 = max.x;
+		}
+		if (y0 < min.y)
+		{
+			v0 += (v1 - v0) * (min.y - y0) / (y1 - y0);
+			y0 = min.y;
+		}
+		if (y1 > max.y)
+		{
+			v1 -= (v1 - v0) * (y1 - max.y) / (y1 - y0);
+			y1 = max.y;
+		}
+
+		WriteQuad(&vertices[kept], x0, x1, y0, y1, u0, u1, v0, v1);
+		kept += vertsPerCharacter;
+	}
+	vertices.resize(kept);
+}
+
+void EmitGlyphRun(VertexData* dst, const VertexData* src, size_t vertexCount, glm::vec3 translation, glm::vec4 color)
+{
+#if GLYPH_EMITTER_SSE2
+	// one unaligned 4 wide add covers position.xyz and atlasUV.x (translated by 0), a second store writes the color
+	const __m128 translate = _mm_setr_ps(translation.x, translation.y, translation.z, 0.0f);
+	const __m128 rgba = _mm_loadu_ps(&color.x);
+	const float* in = reinterpret_cast<const float*>(src);
+	float* out = reinterpret_cast<float*>(dst);
+	for (size_t i = 0; i < vertexCount; i++, in += 9, out += 9)
+	{
+		_mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(in), translate));
+		out[4] = in[4];
+		_mm_storeu_ps(out + 5, rgba);
+	}
+#else
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		dst[i].ep_position = translation + src[i].ep_position;
+		dst[i].atlasUV = src[i].atlasUV;
+		dst[i].color = color;
+	}
+#endif
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "FontAtlas.hpp"
+
+// Per glyph layout results in struct of arrays form, consumed by EmitGlyphQuads.
+// All values are in ems, the font size is applied by the emitter.
+struct GlyphQuadMetrics
+{
+	// quad bounds of the glyph relative to the pen position (kerning already applied)
+	std::vector<float> planeL, planeR, planeB, planeT;
+	// bounds of the glyph in the atlas texture
+	std::vector<float> uvL, uvR, uvB, uvT;
+	// horizontal pen position within the line
+	std::vector<double> cursorX;
+	// horizontal offset of the line due to its alignment
+	std::vector<double> alignX;
+	// vertical offset of the line (line index * line height)
+	std::vector<double> lineY;
+
+	size_t Size() const;
+	void Clear();
+	void Reserve(size_t glyphCount);
+};
+
+// Writes the 6 vertices (position and uv, color is left untouched) of every glyph into out_vertices.
+// Positions are size * (plane + cursor + align) horizontally and size * (plane - line + yoffset) vertically, relative to the text origin.
+// Processes 4 glyphs per iteration with AVX or SSE2 when the compiler targets them, with a scalar fallback otherwise.
+void EmitGlyphQuads(const GlyphQuadMetrics& metrics, float size, double yoffset, VertexData* out_vertices);
+
+// Drops the quads outside of [min, max] and cuts the ones crossing its border, interpolating their uvs.
+// Expects quads as written by EmitGlyphQuads, the remaining quads are compacted to the front of the vector.
+void ClipGlyphQuads(std::vector<VertexData>& vertices, glm::vec2 min, glm::vec2 max);
+
+// Copies a laid out glyph run, translating the positions and overwriting the colors
+void EmitGlyphRun(VertexData* dst, const VertexData* src, size_t vertexCount, glm::vec3 translation, glm::vec4 color);
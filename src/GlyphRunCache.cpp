@@ -0,0 +1,109 @@
+#include "GlyphRunCache.hpp"
+
+#include <functional>
+#include <cstdint>
+#include <cstring>
+
+
+bool GlyphRunCache::Key::operator==(const Key& other) const
+{
+	return atlas == other.atlas && size == other.size && center == other.center && text == other.text;
+}
+
+size_t GlyphRunCache::KeyHash::operator()(const Key& key) const
+{
+	// boost style hash_combine of all key components
+	size_t hash = std::hash<std::string>()(key.text);
+	uint32_t sizeBits;
+	memcpy(&sizeBits, &key.size, sizeof(sizeBits));
+	hash ^= std::hash<unsigned int>()(key.atlas) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	hash ^= std::hash<uint32_t>()(sizeBits) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	hash ^= std::hash<bool>()(key.center) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	return hash;
+}
+
+GlyphRunCache::GlyphRunCache(size_t memoryCap)
+	: memoryUsage_(0), memoryCap_(memoryCap), hits_(0), misses_(0), evictions_(0)
+{
+}
+
+std::shared_ptr<const std::vector<VertexData>> GlyphRunCache::Find(const Key& key)
+{
+	auto it = lookup_.find(key);
+	if (it == lookup_.end())
+	{
+		misses_++;
+		return nullptr;
+	}
+
+	hits_++;
+	entries_.splice(entries_.begin(), entries_, it->second);
+	return it->second->run;
+}
+
+bool GlyphRunCache::Insert(const Key& key, std::shared_ptr<const std::vector<VertexData>> run)
+{
+	size_t byteSize = EntrySize(key, *run);
+	if (byteSize > memoryCap_)
+	{
+		return false;
+	}
+
+	auto existing = lookup_.find(key);
+	if (existing != lookup_.end())
+	{
+		memoryUsage_ -= existing->second->byteSize;
+		entries_.erase(existing->second);
+		lookup_.erase(existing);
+	}
+
+	EvictUntilFits(byteSize);
+
+	entries_.push_front(Entry{ key, std::move(run), byteSize });
+	lookup_[entries_.front().key] = entries_.begin();
+	memoryUsage_ += byteSize;
+	return true;
+}
+
+void GlyphRunCache::SetMemoryCap(size_t bytes)
+{
+	memoryCap_ = bytes;
+	EvictUntilFits(0);
+}
+
+void GlyphRunCache::Clear()
+{
+	lookup_.clear();
+	entries_.clear();
+	memoryUsage_ = 0;
+}
+
+GlyphRunCache::Stats GlyphRunCache::GetStats() const
+{
+	return Stats{ hits_, misses_, evictions_, entries_.size(), memoryUsage_, memoryCap_ };
+}
+
+void GlyphRunCache::ResetStats()
+{
+	hits_ = 0;
+	misses_ = 0;
+	evictions_ = 0;
+}
+
+size_t GlyphRunCache::EntrySize(const Key& key, const std::vector<VertexData>& run)
+{
+	// the key is stored twice, once in the entry and once in the lookup table, the run is allocated separately
+	return sizeof(Entry) + 2 * (sizeof(Key) + key.text.capacity()) + sizeof(run) + run.capacity() * sizeof(VertexData);
+}
+
+void GlyphRunCache::EvictUntilFits(size_t bytes)
+{
+	while (!entries_.empty() && memoryUsage_ + bytes > memoryCap_)
+	{
+		Entry& leastRecentlyUsed = entries_.back();
+		memoryUsage_ -= leastRecentlyUsed.byteSize;
+		lookup_.erase(leastRecentlyUsed.key);
+		entries_.pop_back();
+		evictions_++;
+	}
+}
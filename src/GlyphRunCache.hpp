@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <list>
+#include <unordered_map>
+
+#include "FontAtlas.hpp"
+
+// Least recently used cache of laid out text.
+// A run holds the 6 vertices per glyph produced by the text layout, positioned relative to the text origin.
+// The color of the cached vertices is undefined, it is patched in when the run is emitted.
+// Runs are shared, so a run that was found stays valid after it is evicted and can be read without holding the cache's lock.
+class GlyphRunCache
+{
+public:
+	struct Key
+	{
+		std::string text;
+		unsigned int atlas;
+		float size;
+		bool center;
+
+		bool operator==(const Key& other) const;
+	};
+
+	struct Stats
+	{
+		size_t hits;
+		size_t misses;
+		size_t evictions;
+		size_t entryCount;
+		size_t memoryUsage;
+		size_t memoryCap;
+	};
+
+	explicit GlyphRunCache(size_t memoryCap = 4 * 1024 * 1024);
+
+	// returns the cached run or nullptr and updates the hit/miss counters, a hit becomes the most recently used entry
+	std::shared_ptr<const std::vector<VertexData>> Find(const Key& key);
+	// stores the run, evicting the least recently used entries until it fits. Runs larger than the memory cap are not stored.
+	bool Insert(const Key& key, std::shared_ptr<const std::vector<VertexData>> run);
+
+	// changing the cap evicts entries until the cache fits into it
+	void SetMemoryCap(size_t bytes);
+	void Clear();
+
+	Stats GetStats() const;
+	void ResetStats();
+
+private:
+	struct KeyHash
+	{
+		size_t operator()(const Key& key) const;
+	};
+
+	struct Entry
+	{
+		Key key;
+		std::shared_ptr<const std::vector<VertexData>> run;
+		size_t byteSize;
+	};
+
+	// front is the most recently used entry
+	std::list<Entry> entries_;
+	std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> lookup_;
+
+	size_t memoryUsage_;
+	size_t memoryCap_;
+	size_t hits_;
+	size_t misses_;
+	size_t evictions_;
+
+	static size_t EntrySize(const Key& key, const std::vector<VertexData>& run);
+	void EvictUntilFits(size_t bytes);
+};
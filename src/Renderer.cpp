@@ -4,10 +4,11 @@
 #include "GLFW/glfw3.h"
 #include "glm/ext.hpp"
 
+#include <atomic>
+
 #include "Shader.hpp"
 #include "FontAtlas.hpp"
 
-
 const char* vertexShaderSource = "#version 330 core\n"
 "layout(location = 0) in vec3 vertex; \n"
 "layout(location = 1) in vec2 uv;\n"
@@ -58,18 +59,72 @@ const char* fragmentShaderSource = "#version 330 core\n"
 "	}\n"
 "}\n";
 
+// tiny text is drawn from a coverage atlas, which needs neither the median nor the distance to opacity mapping
+const char* coverageFragmentShaderSource = "#version 330 core\n"
+"in vec2 TexCoords;\n"
+"in vec4 color;\n"
+"\n"
+"uniform sampler2D image;\n"
+"\n"
+"void main()\n"
+"{\n"
+"	float coverage = texture(image, TexCoords).r;\n"
+"	gl_FragColor = vec4(color.rgb, color.a * coverage);\n"
+"\n"
+"	if (coverage <= 0.0)\n"
+"	{\n"
+"		discard;\n"
+"	}\n"
+"}\n";
+
 struct BatchData
 {
 	std::vector<VertexData> textureToQuadVertices = std::vector<VertexData>(256);
 	int quadCount;
 };
 
-// initially space for 240 / 6 = 40 letters
-std::map<unsigned int, BatchData> textureToBatch;
+// vertices written by a single thread during a frame
+struct BatchBuilder
+{
+	// initially space for 240 / 6 = 40 letters per texture
+	std::map<unsigned int, BatchData> textureToBatch;
+	// reused between layouts to avoid reallocating the metric and vertex arrays
+	GlyphQuadMetrics glyphQuadMetrics;
+	std::vector<VertexData> layoutVertices;
+};
+
+struct ThreadBatchBuilder
+{
+	unsigned int rendererId = 0;
+	unsigned int generation = 0;
+	BatchBuilder* builder = nullptr;
+};
+
+static std::atomic<unsigned int> nextRendererId(1);
+// the builder of the renderer this thread drew with last
+static thread_local ThreadBatchBuilder threadBatchBuilder;
+
+// copies the run into the batch, growing it if needed
+static void AppendGlyphRun(BatchData& batchData, const std::vector<VertexData>& run, glm::vec3 position, glm::vec4 color)
+{
+	std::vector<VertexData>& fontVertexData = batchData.textureToQuadVertices;
+
+	// we render each letter as two triangles with 3 verts each
+	const int vertsPerCharacter = 6;
+
+	// check if our batch rendering has anough space for all vertices
+	while (fontVertexData.size() <= batchData.quadCount * vertsPerCharacter + run.size())
+	{
+		fontVertexData.resize(fontVertexData.size() * 2);
+		printf("Resized capacity of batch renderer to: %lu\n", fontVertexData.size());
+	}
 
+	EmitGlyphRun(&fontVertexData[batchData.quadCount * vertsPerCharacter], run.data(), run.size(), position, color);
+	batchData.quadCount += (int)(run.size() / vertsPerCharacter);
+}
 
 Renderer::Renderer()
-	: cameraPosition_(glm::vec2(0,0)), zoom_(1.0f)
+	: cameraPosition_(glm::vec2(0,0)), zoom_(1.0f), smallTextThreshold_(12.0f), batchBuilderGeneration_(0), id_(nextRendererId++)
 {
 	glfwInit();
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
@@ -77,6 +132,10 @@ Renderer::Renderer()
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 }
 
+Renderer::~Renderer()
+{
+}
+
 GLFWwindow* Renderer::CreateWindow(std::string name, glm::vec2 resolution, glm::vec2 worldUnits)
 {
 	screenSize_ = resolution;
@@ -115,6 +174,12 @@ GLFWwindow* Renderer::CreateWindow(std::string name, glm::vec2 resolution, glm::
 	model = glm::translate(model, glm::vec3(80, 40, 0.0f));
 	shader_->SetMatrix4("model", model);
 
+	coverageShader_ = std::make_shared<Shader>();
+	coverageShader_->Compile(vertexShaderSource, coverageFragmentShaderSource);
+	coverageShader_->SetMatrix4("projection", projection_, true);
+	coverageShader_->SetMatrix4("model", model);
+	shader_->Use();
+
 	return window_;
 }
 
@@ -123,15 +188,35 @@ void Renderer::BeginFrame()
 	// wee don't have to clear quadVertices because we will just render the nearly entered totalQuads anyway
 	// clearing and reallocating the memory would only slow things down
 
-	for (auto& batchEntry: textureToBatch)
 	{
-		batchEntry.second.quadCount = 0;
+		std::lock_guard<std::mutex> lock(batchBuildersMutex_);
+		for (auto builder = batchBuilders_.begin(); builder != batchBuilders_.end();)
+		{
+			bool idle = true;
+			for (auto& batchEntry : builder->second->textureToBatch)
+			{
+				idle = idle && batchEntry.second.quadCount == 0;
+				batchEntry.second.quadCount = 0;
+			}
+
+			// threads of a job system come and go, so the builders of threads that did not draw during the last frame are dropped
+			if (idle)
+			{
+				builder = batchBuilders_.erase(builder);
+				batchBuilderGeneration_++;
+			}
+			else
+			{
+				++builder;
+			}
+		}
 	}
 
 	glm::mat4 camera(1.0f);
 	camera = glm::scale(camera, glm::vec3(zoom_, zoom_, 1.0f));
 	camera = glm::translate(camera, glm::vec3(cameraPosition_, 0.f));
-	shader_->SetMatrix4("camera", camera);
+	coverageShader_->SetMatrix4("camera", camera, true);
+	shader_->SetMatrix4("camera", camera, true);
 
 	// for 2d rendering https://github.com/Chlumsky/msdfgen states that screenPxRange can be a precomputed value even.. 
 	// according to be docs sizeInPixels should be the quadsize (so a single letter)
@@ -145,15 +230,65 @@ void Renderer::BeginFrame()
 
 void Renderer::EndFrame(FontAtlas& atlas)
 {
+	std::lock_guard<std::mutex> lock(batchBuildersMutex_);
+
+	shader_->Use();
+	DrawBatches(atlas, atlas.GetTexture());
+
+	std::vector<unsigned int> coverageTextures = atlas.GetCoverageTextures();
+	if (!coverageTextures.empty())
+	{
+		coverageShader_->Use();
+		for (unsigned int texture : coverageTextures)
+		{
+			DrawBatches(atlas, texture);
+		}
+		shader_->Use();
+	}
+}
+
+void Renderer::DrawBatches(FontAtlas& atlas, unsigned int texture)
+{
+	// the batches of all threads are uploaded back to back into the vbo and drawn with a single call
+	std::vector<const BatchData*> batches;
+	size_t totalQuadCount = 0;
+	for (auto& builder : batchBuilders_)
+	{
+		auto batch = builder.second->textureToBatch.find(texture);
+		if (batch != builder.second->textureToBatch.end() && batch->second.quadCount > 0)
+		{
+			batches.push_back(&batch->second);
+			totalQuadCount += batch->second.quadCount;
+		}
+	}
+
+	if (totalQuadCount == 0)
+	{
+		return;
+	}
+
 	glBindBuffer(GL_ARRAY_BUFFER, atlas.GetVBO());
 
-	auto byteSize = sizeof(VertexData) * 6 * textureToBatch[atlas.GetTexture()].quadCount;
-	glBufferData(GL_ARRAY_BUFFER, byteSize, textureToBatch[atlas.GetTexture()].textureToQuadVertices.data(), GL_DYNAMIC_DRAW);
+	if (batches.size() == 1)
+	{
+		glBufferData(GL_ARRAY_BUFFER, sizeof(VertexData) * 6 * totalQuadCount, batches[0]->textureToQuadVertices.data(), GL_DYNAMIC_DRAW);
+	}
+	else
+	{
+		glBufferData(GL_ARRAY_BUFFER, sizeof(VertexData) * 6 * totalQuadCount, nullptr, GL_DYNAMIC_DRAW);
+		size_t byteOffset = 0;
+		for (const BatchData* batch : batches)
+		{
+			auto byteSize = sizeof(VertexData) * 6 * batch->quadCount;
+			glBufferSubData(GL_ARRAY_BUFFER, byteOffset, byteSize, batch->textureToQuadVertices.data());
+			byteOffset += byteSize;
+		}
+	}
 
 	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, atlas.GetTexture());
+	glBindTexture(GL_TEXTURE_2D, texture);
 	glBindVertexArray(atlas.GetQuadVAO());
-	glDrawArrays(GL_TRIANGLES, 0, 6 * textureToBatch[atlas.GetTexture()].quadCount);
+	glDrawArrays(GL_TRIANGLES, 0, GLsizei(6 * totalQuadCount));
 }
 
 glm::vec2 Renderer::GetCameraPosition()
@@ -194,25 +329,116 @@ std::shared_ptr<Shader> Renderer::GetShader()
 	return shader_;
 }
 
+float Renderer::GetSmallTextThreshold()
+{
+	return smallTextThreshold_;
+}
+
+void Renderer::SetSmallTextThreshold(float pixelsPerEm)
+{
+	smallTextThreshold_ = pixelsPerEm;
+}
+
+GlyphRunCache::Stats Renderer::GetGlyphRunCacheStats()
+{
+	std::lock_guard<std::mutex> lock(glyphRunCacheMutex_);
+	return glyphRunCache_.GetStats();
+}
+
+void Renderer::SetGlyphRunCacheMemoryCap(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(glyphRunCacheMutex_);
+	glyphRunCache_.SetMemoryCap(bytes);
+}
+
+BatchBuilder& Renderer::GetThreadBatchBuilder()
+{
+	if (threadBatchBuilder.rendererId != id_ || threadBatchBuilder.generation != batchBuilderGeneration_)
+	{
+		// the thread switched renderers or its builder may have been dropped, so look up the builder it has in this one
+		std::lock_guard<std::mutex> lock(batchBuildersMutex_);
+		std::unique_ptr<BatchBuilder>& builder = batchBuilders_[std::this_thread::get_id()];
+		if (!builder)
+		{
+			builder = std::make_unique<BatchBuilder>();
+		}
+		threadBatchBuilder.rendererId = id_;
+		threadBatchBuilder.generation = batchBuilderGeneration_;
+		threadBatchBuilder.builder = builder.get();
+	}
+	return *threadBatchBuilder.builder;
+}
+
 void Renderer::DrawText(FontAtlas& atlas, std::string text, glm::vec3 position, float size, glm::vec4 color, bool center)
 {
-	BatchData& batchData = textureToBatch[atlas.GetTexture()];
+	// text that ends up only a few pixels tall on screen is drawn from a coverage atlas if the font has one
+	unsigned int fontTexture = atlas.GetTexture();
+	float pixelsPerEm = EuToPixel(glm::vec2(size, size)).y * zoom_;
+	if (pixelsPerEm <= smallTextThreshold_)
+	{
+		atlas.GetCoverageTexture(pixelsPerEm, fontTexture);
+	}
 
-	std::vector<VertexData>& fontVertexData = batchData.textureToQuadVertices;
+	BatchBuilder& builder = GetThreadBatchBuilder();
+	BatchData& batchData = builder.textureToBatch[fontTexture];
+
+	GlyphRunCache::Key key{ text, fontTexture, size, center };
+	std::shared_ptr<const std::vector<VertexData>> cachedRun;
+	{
+		// only the lookup is locked, the shared run stays alive while it is copied even if another thread evicts it
+		std::lock_guard<std::mutex> lock(glyphRunCacheMutex_);
+		cachedRun = glyphRunCache_.Find(key);
+	}
+	if (cachedRun)
+	{
+		AppendGlyphRun(batchData, *cachedRun, position, color);
+		return;
+	}
+
+	// layout happens outside of the lock so threads only serialize on cache access
+	std::shared_ptr<std::vector<VertexData>> uncachedRun = std::make_shared<std::vector<VertexData>>();
+	LayoutText(atlas, fontTexture, text, size, center, builder.glyphQuadMetrics, *uncachedRun);
+	AppendGlyphRun(batchData, *uncachedRun, position, color);
 
+	std::lock_guard<std::mutex> lock(glyphRunCacheMutex_);
+	glyphRunCache_.Insert(key, std::move(uncachedRun));
+}
+
+void Renderer::DrawText(const TextLayout& layout, glm::vec3 position, float size, glm::vec4 color, const TextClipRect* clip)
+{
 	// we render each letter as two triangles with 3 verts each
 	const int vertsPerCharacter = 6;
 
-	constexpr double tabWidthInEms = 2.0;
+	BatchBuilder& builder = GetThreadBatchBuilder();
+	BatchData& batchData = builder.textureToBatch[layout.GetAtlasTexture()];
 
-	// check if our batch rendering has anough space for all vertices
-	while (fontVertexData.size() <= (batchData.quadCount + text.length()) * vertsPerCharacter)
+	GlyphQuadMetrics& metrics = builder.glyphQuadMetrics;
+	double yoffset = layout.BuildGlyphQuads(metrics);
+
+	std::vector<VertexData>& run = builder.layoutVertices;
+	run.resize(metrics.Size() * vertsPerCharacter);
+	EmitGlyphQuads(metrics, size, yoffset, run.data());
+
+	if (clip != nullptr)
 	{
-		fontVertexData.resize(fontVertexData.size() * 2);
-		printf("Resized capacity of batch renderer to: %lu\n", fontVertexData.size());
+		// the run is relative to the text origin
+		ClipGlyphQuads(run, clip->min - glm::vec2(position), clip->max - glm::vec2(position));
 	}
 
-	unsigned int fontTexture = atlas.GetTexture();
+	AppendGlyphRun(batchData, run, position, color);
+}
+
+void Renderer::LayoutText(FontAtlas& atlas, unsigned int fontTexture, const std::string& text, float size, bool center, GlyphQuadMetrics& scratch, std::vector<VertexData>& out_vertices)
+{
+	// we render each letter as two triangles with 3 verts each
+	const int vertsPerCharacter = 6;
+
+	constexpr double tabWidthInEms = 2.0;
+
+	// gather the glyph metrics first so the quads can be emitted several glyphs at a time
+	GlyphQuadMetrics& metrics = scratch;
+	metrics.Clear();
+	metrics.Reserve(text.length());
 
 	double fontLineHeight = 0.0, fontAscenderHeight = 0.0, fontDescenderHeight = 0.0;
 	atlas.GetFontVerticalMetrics(fontTexture, fontLineHeight, fontAscenderHeight, fontDescenderHeight);
@@ -281,30 +507,27 @@ void Renderer::DrawText(FontAtlas& atlas, std::string text, glm::vec3 position,
 
 		float l, r, b, t;
 		atlas.GetFontCharUVBounds(fontTexture, c, l, r, b, t);
-		fontVertexData[batchData.quadCount * vertsPerCharacter].atlasUV	 = { l, t }; //lt
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 1].atlasUV = { r, b }; //rb
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 2].atlasUV = { l, b }; //lb
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 3].atlasUV = { l, t }; //lt
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 4].atlasUV = { r, t }; //rt
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 5].atlasUV = { r, b }; //rb
+		metrics.uvL.push_back(l);
+		metrics.uvR.push_back(r);
+		metrics.uvB.push_back(b);
+		metrics.uvT.push_back(t);
 
 		atlas.GetFontCharQuadBounds(fontTexture, c, l, r, b, t, prevChar);
-		fontVertexData[batchData.quadCount * vertsPerCharacter].ep_position	 = position + glm::vec3(size * (l + cursorPos + xoffset), size * (t - currentLine * fontLineHeight + yoffset), 0); // lt
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 1].ep_position = position + glm::vec3(size * (r + cursorPos + xoffset), size * (b - currentLine * fontLineHeight + yoffset), 0); // rb
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 2].ep_position = position + glm::vec3(size * (l + cursorPos + xoffset), size * (b - currentLine * fontLineHeight + yoffset), 0); // lb
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 3].ep_position = position + glm::vec3(size * (l + cursorPos + xoffset), size * (t - currentLine * fontLineHeight + yoffset), 0); // lt
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 4].ep_position = position + glm::vec3(size * (r + cursorPos + xoffset), size * (t - currentLine * fontLineHeight + yoffset), 0); // rt
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 5].ep_position = position + glm::vec3(size * (r + cursorPos + xoffset), size * (b - currentLine * fontLineHeight + yoffset), 0); // rb
-
-		fontVertexData[batchData.quadCount * vertsPerCharacter].color = color;
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 1].color = color;
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 2].color = color;
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 3].color = color;
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 4].color = color;
-		fontVertexData[batchData.quadCount * vertsPerCharacter + 5].color = color;
-
-		batchData.quadCount++;
+		metrics.planeL.push_back(l);
+		metrics.planeR.push_back(r);
+		metrics.planeB.push_back(b);
+		metrics.planeT.push_back(t);
+
+		metrics.cursorX.push_back(cursorPos);
+		metrics.alignX.push_back(xoffset);
+		metrics.lineY.push_back(currentLine * fontLineHeight);
+
 		prevChar = c;
 		cursorPos += atlas.GetFontCharAdvance(fontTexture, c);
 	}
+
+	// positions are relative to the text origin, the translation is applied when the run is emitted
+	size_t first = out_vertices.size();
+	out_vertices.resize(first + metrics.Size() * vertsPerCharacter);
+	EmitGlyphQuads(metrics, size, yoffset, out_vertices.data() + first);
 }
\ No newline at end of file
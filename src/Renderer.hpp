@@ -1,11 +1,22 @@
+#pragma once
+
 #include <string>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "glm/glm.hpp"
 
+#include "GlyphRunCache.hpp"
+#include "GlyphQuadEmitter.hpp"
+#include "TextLayout.hpp"
+
 struct GLFWwindow;
 class Shader;
 class FontAtlas;
+struct BatchBuilder;
 class Renderer
 {
 	//Projects the ingame units to normalized opengl coordinates ([-1,1])
@@ -17,13 +28,39 @@ class Renderer
 	float zoom_;
 
 	std::shared_ptr<Shader> shader_;
+	std::shared_ptr<Shader> coverageShader_;
+
+	// text with fewer pixels per em on screen is drawn from the coverage atlases of its font
+	float smallTextThreshold_;
 
 	glm::vec2 screenSize_;
 	glm::vec2 worldSize_;
 	GLFWwindow* window_;
 
+	// laid out text of previous DrawText calls, reused when only position or color changed
+	GlyphRunCache glyphRunCache_;
+	std::mutex glyphRunCacheMutex_;
+
+	// every thread that calls DrawText gets its own batch builder, they are merged at EndFrame
+	std::map<std::thread::id, std::unique_ptr<BatchBuilder>> batchBuilders_;
+	std::mutex batchBuildersMutex_;
+	// incremented when BeginFrame drops the builders of threads that stopped drawing, which invalidates the thread local builder lookup
+	unsigned int batchBuilderGeneration_;
+	// identifies this renderer in the thread local builder lookup
+	unsigned int id_;
+
+	// returns the batch builder of the calling thread, creating it on the thread's first use of this renderer
+	BatchBuilder& GetThreadBatchBuilder();
+
+	// uploads and draws the batches of all threads for one texture
+	void DrawBatches(FontAtlas& atlas, unsigned int texture);
+
+	// lays out the text relative to its origin using the metrics of fontTexture, appends 6 vertices per glyph (color is left unset)
+	void LayoutText(FontAtlas& atlas, unsigned int fontTexture, const std::string& text, float size, bool center, GlyphQuadMetrics& scratch, std::vector<VertexData>& out_vertices);
+
 public:
 	Renderer();
+	~Renderer();
 	GLFWwindow* CreateWindow(std::string name, glm::vec2 resolution, glm::vec2 worldUnits);
 	void BeginFrame();
 	void EndFrame(FontAtlas& atlas);
@@ -40,5 +77,16 @@ public:
 
 	std::shared_ptr<Shader> GetShader();
 
+	// may be called from several threads at once between BeginFrame and EndFrame,
+	// each thread writes into its own batch builder
 	void DrawText(FontAtlas& atlas, std::string text, glm::vec3 position, float size, glm::vec4 color, bool center = true);
+	// draws wrapped and aligned text, the lines start at position and go downwards like above. Glyphs outside of clip are cut away.
+	// Layouts always use the msdf atlas they were measured with.
+	void DrawText(const TextLayout& layout, glm::vec3 position, float size, glm::vec4 color, const TextClipRect* clip = nullptr);
+
+	float GetSmallTextThreshold();
+	void SetSmallTextThreshold(float pixelsPerEm);
+
+	GlyphRunCache::Stats GetGlyphRunCacheStats();
+	void SetGlyphRunCacheMemoryCap(size_t bytes);
 };
\ No newline at end of file
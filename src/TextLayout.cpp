@@ -0,0 +1,268 @@
+#include "TextLayout.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+#include "FontAtlas.hpp"
+
+
+constexpr double tabWidthInEms = 2.0;
+
+static bool IsWhitespace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+static bool IsLineBreak(char c)
+{
+	return c == '\n' || c == '\f';
+}
+
+TextLayout::TextLayout(FontAtlas& atlas, const std::string& text)
+	: text_(text), atlasTexture_(atlas.GetTexture()), lineHeight_(0.0), descenderHeight_(0.0), maxWidth_(0.0), align_(TextAlign::Left)
+{
+	double ascenderHeight = 0.0;
+	atlas.GetFontVerticalMetrics(atlasTexture_, lineHeight_, ascenderHeight, descenderHeight_);
+
+	// single pass over the text gathering glyph metrics, advance prefix sums and the word segments
+	glyphs_.resize(text_.size());
+	advancePrefix_.resize(text_.size() + 1);
+	advancePrefix_[0] = 0.0;
+
+	char prevChar = 0;
+	for (size_t i = 0; i < text_.size(); i++)
+	{
+		char c = text_[i];
+		double advance = 0.0;
+		// control characters have no glyph, spaces are measured but not drawn
+		if (c != '\t' && c != '\r' && !IsLineBreak(c))
+		{
+			advance = atlas.GetFontCharAdvance(atlasTexture_, c);
+			if (c != ' ')
+			{
+				Glyph& glyph = glyphs_[i];
+				atlas.GetFontCharUVBounds(atlasTexture_, c, glyph.uvL, glyph.uvR, glyph.uvB, glyph.uvT);
+				atlas.GetFontCharQuadBounds(atlasTexture_, c, glyph.planeL, glyph.planeR, glyph.planeB, glyph.planeT, prevChar);
+			}
+			prevChar = c;
+		}
+		advancePrefix_[i + 1] = advancePrefix_[i] + advance;
+	}
+
+	size_t i = 0;
+	while (i < text_.size())
+	{
+		Segment segment = {};
+		segment.wordBegin = i;
+		while (i < text_.size() && !IsWhitespace(text_[i]))
+		{
+			i++;
+		}
+		segment.wordEnd = i;
+		while (i < text_.size() && IsWhitespace(text_[i]))
+		{
+			char c = text_[i++];
+			if (IsLineBreak(c))
+			{
+				segment.hardBreak = true;
+				break;
+			}
+			segment.spaceHasTab |= c == '\t';
+		}
+		segment.spaceEnd = i;
+		segment.wordWidth = advancePrefix_[segment.wordEnd] - advancePrefix_[segment.wordBegin];
+		segment.spaceWidth = advancePrefix_[segment.spaceEnd] - advancePrefix_[segment.wordEnd];
+		segments_.push_back(segment);
+	}
+
+	Wrap(0.0);
+}
+
+double TextLayout::AdvanceWhitespace(const Segment& segment, double cursorPos) const
+{
+	if (!segment.spaceHasTab)
+	{
+		return cursorPos + segment.spaceWidth;
+	}
+
+	for (size_t i = segment.wordEnd; i < segment.spaceEnd; i++)
+	{
+		if (text_[i] == '\t')
+		{
+			unsigned int cursorPosRoundedDown = (unsigned int)cursorPos;
+			cursorPos = double(cursorPosRoundedDown) + tabWidthInEms - fmod(cursorPosRoundedDown, tabWidthInEms);
+		}
+		else
+		{
+			cursorPos += advancePrefix_[i + 1] - advancePrefix_[i];
+		}
+	}
+	return cursorPos;
+}
+
+void TextLayout::Wrap(double maxWidth, TextAlign align)
+{
+	maxWidth_ = maxWidth;
+	align_ = align;
+	lines_.clear();
+
+	// greedy line breaking, each word is measured in constant time through the cached segments
+	Line line = { 0, 0, 0.0, 0, false };
+	bool lineHasWord = false;
+	double cursorPos = 0.0;
+	for (const Segment& segment : segments_)
+	{
+		if (segment.wordEnd > segment.wordBegin)
+		{
+			if (lineHasWord && maxWidth > 0.0 && cursorPos + segment.wordWidth > maxWidth)
+			{
+				lines_.push_back(line);
+				line = { segment.wordBegin, segment.wordBegin, 0.0, 0, false };
+				lineHasWord = false;
+				cursorPos = 0.0;
+			}
+
+			if (lineHasWord)
+			{
+				line.gapCount++;
+			}
+			cursorPos += segment.wordWidth;
+			line.end = segment.wordEnd;
+			line.width = cursorPos;
+			lineHasWord = true;
+		}
+		else if (!lineHasWord)
+		{
+			// leading whitespace of a paragraph indents the line
+			line.end = segment.wordEnd;
+		}
+
+		if (segment.hardBreak)
+		{
+			line.endsParagraph = true;
+			lines_.push_back(line);
+			line = { segment.spaceEnd, segment.spaceEnd, 0.0, 0, false };
+			lineHasWord = false;
+			cursorPos = 0.0;
+		}
+		else
+		{
+			cursorPos = AdvanceWhitespace(segment, cursorPos);
+		}
+	}
+
+	line.endsParagraph = true;
+	lines_.push_back(line);
+}
+
+double TextLayout::MeasureWidth(size_t begin, size_t end) const
+{
+	return advancePrefix_[end] - advancePrefix_[begin];
+}
+
+glm::dvec2 TextLayout::GetSize() const
+{
+	double width = 0.0;
+	for (const Line& line : lines_)
+	{
+		width = std::max(width, line.width);
+	}
+	return glm::dvec2(width, lines_.size() * lineHeight_);
+}
+
+const std::vector<TextLayout::Line>& TextLayout::GetLines() const
+{
+	return lines_;
+}
+
+const std::string& TextLayout::GetText() const
+{
+	return text_;
+}
+
+unsigned int TextLayout::GetAtlasTexture() const
+{
+	return atlasTexture_;
+}
+
+double TextLayout::BuildGlyphQuads(GlyphQuadMetrics& out_metrics) const
+{
+	out_metrics.Clear();
+	out_metrics.Reserve(text_.size());
+
+	// without a max width the lines are aligned around the text origin like DrawText does
+	double boxWidth = maxWidth_ > 0.0 ? maxWidth_ : 0.0;
+
+	for (size_t lineIndex = 0; lineIndex < lines_.size(); lineIndex++)
+	{
+		const Line& line = lines_[lineIndex];
+
+		double xoffset = 0.0;
+		double gapStretch = 0.0;
+		switch (align_)
+		{
+		case TextAlign::Left:
+			break;
+		case TextAlign::Center:
+			xoffset = (boxWidth - line.width) / 2.0;
+			break;
+		case TextAlign::Right:
+			xoffset = boxWidth - line.width;
+			break;
+		case TextAlign::Justify:
+			if (maxWidth_ > 0.0 && !line.endsParagraph && line.gapCount > 0)
+			{
+				gapStretch = (maxWidth_ - line.width) / line.gapCount;
+			}
+			break;
+		}
+
+		// the stretch is kept apart from the cursor so tab stops stay where the line breaking put them
+		double cursorPos = 0.0;
+		double stretch = 0.0;
+		bool afterWord = false;
+		bool inGap = false;
+		for (size_t i = line.begin; i < line.end; i++)
+		{
+			char c = text_[i];
+			if (IsWhitespace(c))
+			{
+				if (c == '\t')
+				{
+					unsigned int cursorPosRoundedDown = (unsigned int)cursorPos;
+					cursorPos = double(cursorPosRoundedDown) + tabWidthInEms - fmod(cursorPosRoundedDown, tabWidthInEms);
+				}
+				else
+				{
+					cursorPos += advancePrefix_[i + 1] - advancePrefix_[i];
+				}
+				inGap = afterWord;
+				continue;
+			}
+
+			if (inGap)
+			{
+				stretch += gapStretch;
+				inGap = false;
+			}
+			afterWord = true;
+
+			const Glyph& glyph = glyphs_[i];
+			out_metrics.planeL.push_back(glyph.planeL);
+			out_metrics.planeR.push_back(glyph.planeR);
+			out_metrics.planeB.push_back(glyph.planeB);
+			out_metrics.planeT.push_back(glyph.planeT);
+			out_metrics.uvL.push_back(glyph.uvL);
+			out_metrics.uvR.push_back(glyph.uvR);
+			out_metrics.uvB.push_back(glyph.uvB);
+			out_metrics.uvT.push_back(glyph.uvT);
+			out_metrics.cursorX.push_back(cursorPos + stretch);
+			out_metrics.alignX.push_back(xoffset);
+			out_metrics.lineY.push_back(lineIndex * lineHeight_);
+
+			cursorPos += advancePrefix_[i + 1] - advancePrefix_[i];
+		}
+	}
+
+	return descenderHeight_ - 1.0;
+}
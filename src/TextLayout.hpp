@@ -0,0 +1,102 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "GlyphQuadEmitter.hpp"
+
+class FontAtlas;
+
+enum class TextAlign
+{
+	Left,
+	Center,
+	Right,
+	// stretches the spaces between words so lines fill the max width, the last line of a paragraph stays left aligned
+	Justify
+};
+
+// rectangle in engine units, glyphs outside are dropped and glyphs on the border are cut
+struct TextClipRect
+{
+	glm::vec2 min;
+	glm::vec2 max;
+};
+
+// Lays out text with word wrapping and alignment.
+// The font metrics of every character, prefix sums of the advances and the break opportunities (whitespace runs and newlines)
+// are gathered once on construction, so wrapping at a new width is a single pass over the words without touching the font atlas.
+// Widths and positions are in ems, the font size is applied when drawing.
+class TextLayout
+{
+public:
+	struct Line
+	{
+		// character range of the line without its trailing whitespace
+		size_t begin;
+		size_t end;
+		double width;
+		// whitespace runs between words, stretched by justified alignment
+		unsigned int gapCount;
+		// the line ends at a newline or at the end of the text
+		bool endsParagraph;
+	};
+
+	TextLayout(FontAtlas& atlas, const std::string& text);
+
+	// breaks lines at word boundaries so they are not wider than maxWidth, maxWidth <= 0 only breaks at newlines.
+	// Single words wider than maxWidth are not split and overflow the line.
+	void Wrap(double maxWidth, TextAlign align = TextAlign::Left);
+
+	// width of the characters [begin, end) on a single line, tabs and line breaks count as zero width
+	double MeasureWidth(size_t begin, size_t end) const;
+	// size of the wrapped text, width of the widest line and height of all lines
+	glm::dvec2 GetSize() const;
+
+	const std::vector<Line>& GetLines() const;
+	const std::string& GetText() const;
+	unsigned int GetAtlasTexture() const;
+
+	// writes the glyphs of the wrapped lines for EmitGlyphQuads, returns the yoffset to pass along
+	double BuildGlyphQuads(GlyphQuadMetrics& out_metrics) const;
+
+private:
+	struct Glyph
+	{
+		float planeL, planeR, planeB, planeT;
+		float uvL, uvR, uvB, uvT;
+	};
+
+	// a word followed by its whitespace run
+	struct Segment
+	{
+		size_t wordBegin;
+		size_t wordEnd;
+		size_t spaceEnd;
+		double wordWidth;
+		// width of the whitespace run if it starts the cursor at 0 and contains no tabs
+		double spaceWidth;
+		bool spaceHasTab;
+		// the whitespace run ends with a newline, the next segment starts a new paragraph
+		bool hardBreak;
+	};
+
+	std::string text_;
+	unsigned int atlasTexture_;
+	double lineHeight_;
+	double descenderHeight_;
+
+	std::vector<Glyph> glyphs_;
+	// advancePrefix_[i] is the sum of the advances of the characters before i
+	std::vector<double> advancePrefix_;
+	std::vector<Segment> segments_;
+
+	double maxWidth_;
+	TextAlign align_;
+	std::vector<Line> lines_;
+
+	// moves the cursor over the whitespace run of the segment
+	double AdvanceWhitespace(const Segment& segment, double cursorPos) const;
+};
@@ -94,7 +94,8 @@ int main(int argc, char *argv[])
     glfwSetKeyCallback(window, key_callback);
     glfwSetScrollCallback(window, scroll_callback);
 
-    FontAtlas arial = FontAtlas(argv[1]);
+    // the coverage atlases take over when zooming out far enough for the text to get tiny
+    FontAtlas arial = FontAtlas(argv[1], { 8, 12 });
 
     auto currentFrame = std::chrono::steady_clock::now();
     auto lastFrame = std::chrono::steady_clock::now();